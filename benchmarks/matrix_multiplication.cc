@@ -1,8 +1,10 @@
+#include "autotune.h"
 #include "field.h"
 #include "gf256/gf256.h"
 
 #include <benchmark/benchmark.h>
 #include <random>
+#include <set>
 #include <vector>
 
 template <typename T, typename R> void FillRandom(std::vector<T> &v, R &rng) {
@@ -86,6 +88,223 @@ static void BM_MatMulGFNIDedicated(benchmark::State &state) {
   }
 }
 
+template <typename R>
+void FillSparse(std::vector<gf_2_8::element_t> &v, size_t density, R &rng) {
+  for (auto &x : v) {
+    x = (rng() % 100 < density) ? rng() : 0;
+  }
+}
+
+static void BM_MatMulDenseOnSparse(benchmark::State &state) {
+  size_t n = state.range(0);
+  size_t density = state.range(1);
+  std::mt19937_64 rng(42);
+
+  std::vector<gf_2_8::element_t> left(n * n);
+  std::vector<gf_2_8::element_t> right(n * n);
+  std::vector<gf_2_8::element_t> result(n * n);
+  FillSparse(left, density, rng);
+  FillRandom(right, rng);
+
+  for (auto _ : state) {
+    gf_2_8::MatMul(left.data(), right.data(), n, n, n,
+                   gf_2_8::AddScaledRowGFNIDedicated, result.data());
+  }
+}
+
+static void BM_SparseMatMul(benchmark::State &state) {
+  size_t n = state.range(0);
+  size_t density = state.range(1);
+  std::mt19937_64 rng(42);
+
+  std::vector<gf_2_8::element_t> left(n * n);
+  std::vector<gf_2_8::element_t> right(n * n);
+  std::vector<gf_2_8::element_t> result(n * n);
+  FillSparse(left, density, rng);
+  FillRandom(right, rng);
+  auto sparse = gf_2_8::ToSparse(left.data(), n, n);
+
+  for (auto _ : state) {
+    gf_2_8::SparseMatMul(sparse, right.data(), n,
+                         gf_2_8::AddScaledRowGFNIDedicated, result.data());
+  }
+}
+
+static void BM_TransposeScalar(benchmark::State &state) {
+  size_t n = state.range(0);
+  std::mt19937_64 rng(42);
+
+  std::vector<gf_2_8::element_t> src(n * n);
+  std::vector<gf_2_8::element_t> dst(n * n);
+  FillRandom(src, rng);
+
+  for (auto _ : state) {
+    for (size_t r = 0; r < n; ++r) {
+      for (size_t c = 0; c < n; ++c) {
+        dst[c * n + r] = src[r * n + c];
+      }
+    }
+    benchmark::DoNotOptimize(dst.data());
+  }
+  state.SetBytesProcessed(state.iterations() * n * n);
+}
+
+static void BM_Transpose(benchmark::State &state) {
+  size_t n = state.range(0);
+  std::mt19937_64 rng(42);
+
+  std::vector<gf_2_8::element_t> src(n * n);
+  std::vector<gf_2_8::element_t> dst(n * n);
+  FillRandom(src, rng);
+
+  for (auto _ : state) {
+    gf_2_8::Transpose(src.data(), n, n, dst.data());
+    benchmark::DoNotOptimize(dst.data());
+  }
+  state.SetBytesProcessed(state.iterations() * n * n);
+}
+
+static void BM_MatMulTransposeThenMul(benchmark::State &state) {
+  size_t m_i = state.range(0);
+  size_t n = state.range(1);
+  std::mt19937_64 rng(42);
+
+  std::vector<gf_2_8::element_t> left(m_i * n);
+  std::vector<gf_2_8::element_t> right_t(n * n);
+  std::vector<gf_2_8::element_t> right(n * n);
+  std::vector<gf_2_8::element_t> result(m_i * n);
+  FillRandom(left, rng);
+  FillRandom(right_t, rng);
+
+  for (auto _ : state) {
+    gf_2_8::Transpose(right_t.data(), n, n, right.data());
+    gf_2_8::MatMul(left.data(), right.data(), m_i, n, n,
+                   gf_2_8::AddScaledRowGFNIDedicated, result.data());
+  }
+}
+
+static void BM_MatMulColMajorRight(benchmark::State &state) {
+  size_t m_i = state.range(0);
+  size_t n = state.range(1);
+  std::mt19937_64 rng(42);
+
+  std::vector<gf_2_8::element_t> left(m_i * n);
+  std::vector<gf_2_8::element_t> right_t(n * n);
+  std::vector<gf_2_8::element_t> result(m_i * n);
+  FillRandom(left, rng);
+  FillRandom(right_t, rng);
+
+  for (auto _ : state) {
+    gf_2_8::MatMul(left.data(), gf_2_8::Layout::kRowMajor, right_t.data(),
+                   gf_2_8::Layout::kColMajor, m_i, n, n,
+                   gf_2_8::AddScaledRowGFNIDedicated, result.data());
+  }
+}
+
+// Encoding-like shape: few coefficient rows and long shards, so that
+// right operand exceeds last level cache for large m_j
+constexpr size_t streaming_m_i = 4;
+constexpr size_t streaming_m_k = 10;
+
+static void BM_MatMulLongRows(benchmark::State &state) {
+  size_t m_j = state.range(0);
+  std::mt19937_64 rng(42);
+
+  std::vector<gf_2_8::element_t> left(streaming_m_i * streaming_m_k);
+  std::vector<gf_2_8::element_t> right(streaming_m_k * m_j);
+  std::vector<gf_2_8::element_t> result(streaming_m_i * m_j);
+  FillRandom(left, rng);
+  FillRandom(right, rng);
+
+  for (auto _ : state) {
+    gf_2_8::MatMul(left.data(), right.data(), streaming_m_i, streaming_m_k,
+                   m_j, gf_2_8::AddScaledRowGFNIDedicated, result.data());
+  }
+  state.SetBytesProcessed(state.iterations() * (streaming_m_i + streaming_m_k) *
+                          m_j);
+}
+
+static void BM_MatMulStreaming(benchmark::State &state) {
+  size_t m_j = state.range(0);
+  gf_2_8::StreamingParams params;
+  params.tile_columns = state.range(1);
+  params.prefetch_rows = state.range(2);
+  params.non_temporal = state.range(3);
+  std::mt19937_64 rng(42);
+
+  std::vector<gf_2_8::element_t> left(streaming_m_i * streaming_m_k);
+  std::vector<gf_2_8::element_t> right(streaming_m_k * m_j);
+  std::vector<gf_2_8::element_t> result(streaming_m_i * m_j);
+  FillRandom(left, rng);
+  FillRandom(right, rng);
+
+  for (auto _ : state) {
+    gf_2_8::MatMulStreaming(left.data(), right.data(), streaming_m_i,
+                            streaming_m_k, m_j,
+                            gf_2_8::AddScaledRowGFNIDedicated, params,
+                            result.data());
+  }
+  state.SetBytesProcessed(state.iterations() * (streaming_m_i + streaming_m_k) *
+                          m_j);
+}
+
+template <typename T, typename MatMul, typename Kernel>
+void MatMulWide(benchmark::State &state, MatMul mat_mul, Kernel fma) {
+  size_t n = state.range(0);
+  std::mt19937_64 rng(42);
+
+  std::vector<T> left(n * n);
+  std::vector<T> right(n * n);
+  std::vector<T> result(n * n);
+
+  for (auto _ : state) {
+    FillRandom(left, rng);
+    FillRandom(right, rng);
+    mat_mul(left.data(), right.data(), n, n, n, fma, result.data());
+  }
+}
+
+static void BM_MatMul_2_32_Base(benchmark::State &state) {
+  MatMulWide<gf_2_32::element_t>(state, gf_2_32::MatMul,
+                                 gf_2_32::AddScaledRowBase);
+}
+
+static void BM_MatMul_2_32_CLMUL(benchmark::State &state) {
+  MatMulWide<gf_2_32::element_t>(state, gf_2_32::MatMul,
+                                 gf_2_32::AddScaledRowCLMUL);
+}
+
+static void BM_MatMul_2_64_Base(benchmark::State &state) {
+  MatMulWide<gf_2_64::element_t>(state, gf_2_64::MatMul,
+                                 gf_2_64::AddScaledRowBase);
+}
+
+static void BM_MatMul_2_64_CLMUL(benchmark::State &state) {
+  MatMulWide<gf_2_64::element_t>(state, gf_2_64::MatMul,
+                                 gf_2_64::AddScaledRowCLMUL);
+}
+
+static void BM_MatMulTuned(benchmark::State &state) {
+  size_t n = state.range(0);
+  std::mt19937_64 rng(42);
+  // Benchmark function is called several times per argument, shape is
+  // tuned on the first call and taken from tuning cache afterwards
+  static std::set<size_t> tuned;
+  if (tuned.insert(n).second) {
+    gf_2_8::Autotune(n, n, n);
+  }
+
+  std::vector<gf_2_8::element_t> left(n * n);
+  std::vector<gf_2_8::element_t> right(n * n);
+  std::vector<gf_2_8::element_t> result(n * n);
+
+  for (auto _ : state) {
+    FillRandom(left, rng);
+    FillRandom(right, rng);
+    gf_2_8::MatMulTuned(left.data(), right.data(), n, n, n, result.data());
+  }
+}
+
 BENCHMARK(BM_MatMulBase)
     ->Name("BinaryTable")
     ->ArgNames({"n"})
@@ -109,3 +328,87 @@ BENCHMARK(BM_MatMulGFNIDedicated)
     ->ArgNames({"n"})
     ->RangeMultiplier(2)
     ->Range(16, 2048);
+
+BENCHMARK(BM_MatMulTuned)
+    ->Name("Autotuned")
+    ->ArgNames({"n"})
+    ->RangeMultiplier(2)
+    ->Range(16, 2048);
+
+BENCHMARK(BM_MatMulDenseOnSparse)
+    ->Name("GFNIMulDenseOnSparse")
+    ->ArgNames({"n", "density"})
+    ->ArgsProduct({{256, 1024}, {1, 5, 10, 25, 50}});
+
+BENCHMARK(BM_SparseMatMul)
+    ->Name("GFNIMulSparse")
+    ->ArgNames({"n", "density"})
+    ->ArgsProduct({{256, 1024}, {1, 5, 10, 25, 50}});
+
+BENCHMARK(BM_TransposeScalar)
+    ->Name("TransposeScalar")
+    ->ArgNames({"n"})
+    ->RangeMultiplier(4)
+    ->Range(64, 4096);
+
+BENCHMARK(BM_Transpose)
+    ->Name("Transpose")
+    ->ArgNames({"n"})
+    ->RangeMultiplier(4)
+    ->Range(64, 4096);
+
+// Square shapes and few rows of left against right of 64 MiB, where
+// transposing first adds a pass over right that does not fit in cache
+BENCHMARK(BM_MatMulTransposeThenMul)
+    ->Name("GFNIMulTransposeThenMul")
+    ->ArgNames({"m_i", "n"})
+    ->Args({64, 64})
+    ->Args({256, 256})
+    ->Args({1024, 1024})
+    ->Args({16, 8192});
+
+BENCHMARK(BM_MatMulColMajorRight)
+    ->Name("GFNIMulColMajorRight")
+    ->ArgNames({"m_i", "n"})
+    ->Args({64, 64})
+    ->Args({256, 256})
+    ->Args({1024, 1024})
+    ->Args({16, 8192});
+
+BENCHMARK(BM_MatMulLongRows)
+    ->Name("GFNIMulLongRows")
+    ->ArgNames({"m_j"})
+    ->RangeMultiplier(8)
+    ->Range(1 << 14, 1 << 23);
+
+BENCHMARK(BM_MatMulStreaming)
+    ->Name("GFNIMulStreaming")
+    ->ArgNames({"m_j", "tile", "prefetch", "nt"})
+    ->ArgsProduct({{1 << 14, 1 << 17, 1 << 20, 1 << 23},
+                   {4096, 16384},
+                   {0, 4},
+                   {0, 1}});
+
+BENCHMARK(BM_MatMul_2_32_Base)
+    ->Name("GF32CLMULScalar")
+    ->ArgNames({"n"})
+    ->RangeMultiplier(2)
+    ->Range(16, 512);
+
+BENCHMARK(BM_MatMul_2_32_CLMUL)
+    ->Name("GF32VPCLMUL")
+    ->ArgNames({"n"})
+    ->RangeMultiplier(2)
+    ->Range(16, 512);
+
+BENCHMARK(BM_MatMul_2_64_Base)
+    ->Name("GF64CLMULScalar")
+    ->ArgNames({"n"})
+    ->RangeMultiplier(2)
+    ->Range(16, 512);
+
+BENCHMARK(BM_MatMul_2_64_CLMUL)
+    ->Name("GF64VPCLMUL")
+    ->ArgNames({"n"})
+    ->RangeMultiplier(2)
+    ->Range(16, 512);
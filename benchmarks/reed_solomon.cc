@@ -0,0 +1,134 @@
+#include "reed_solomon.h"
+
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+namespace {
+
+template <typename T, typename Encoder>
+std::vector<T> RandomCodewords(size_t n, size_t parity, size_t batch,
+                               std::mt19937_64 &rng, Encoder encode) {
+  std::vector<T> codewords(n * batch);
+  std::vector<T> message(n - parity);
+  std::vector<T> codeword(n);
+  for (size_t b = 0; b < batch; ++b) {
+    for (auto &x : message) {
+      x = rng();
+    }
+    encode(message.data(), n - parity, parity, codeword.data());
+    for (size_t j = 0; j < n; ++j) {
+      codewords[j * batch + b] = codeword[j];
+    }
+  }
+  return codewords;
+}
+
+/**
+ * Puts @p errors errors into every codeword of the batch
+ */
+template <typename T>
+void AddErrors(std::vector<T> &codewords, size_t n, size_t batch,
+               size_t errors, std::mt19937_64 &rng) {
+  for (size_t b = 0; b < batch; ++b) {
+    for (size_t e = 0; e < errors; ++e) {
+      codewords[(rng() % n) * batch + b] ^= 1 + rng() % 255;
+    }
+  }
+}
+
+} // namespace
+
+static void BM_RSDecodeClean_2_8(benchmark::State &state) {
+  size_t n = 255;
+  size_t parity = state.range(0);
+  size_t batch = state.range(1);
+  std::mt19937_64 rng(42);
+  gf_2_8::Init();
+
+  auto codewords = RandomCodewords<gf_2_8::element_t>(n, parity, batch, rng,
+                                                      gf_2_8::RSEncode);
+  for (auto _ : state) {
+    auto failed = gf_2_8::RSDecodeBatch(codewords.data(), n, parity, batch);
+    benchmark::DoNotOptimize(failed);
+  }
+  state.SetBytesProcessed(state.iterations() * n * batch);
+}
+
+static void BM_RSDecodeErrors_2_8(benchmark::State &state) {
+  size_t n = 255;
+  size_t parity = state.range(0);
+  size_t batch = state.range(1);
+  std::mt19937_64 rng(42);
+  gf_2_8::Init();
+
+  auto ref = RandomCodewords<gf_2_8::element_t>(n, parity, batch, rng,
+                                                gf_2_8::RSEncode);
+  auto codewords = ref;
+  for (auto _ : state) {
+    state.PauseTiming();
+    codewords = ref;
+    AddErrors(codewords, n, batch, parity / 2, rng);
+    state.ResumeTiming();
+    auto failed = gf_2_8::RSDecodeBatch(codewords.data(), n, parity, batch);
+    benchmark::DoNotOptimize(failed);
+  }
+  state.SetBytesProcessed(state.iterations() * n * batch);
+}
+
+static void BM_RSDecodeClean_2_16(benchmark::State &state) {
+  size_t n = 1024;
+  size_t parity = state.range(0);
+  size_t batch = state.range(1);
+  std::mt19937_64 rng(42);
+  gf_2_8::Init();
+
+  auto codewords = RandomCodewords<gf_2_16::element_t>(n, parity, batch, rng,
+                                                       gf_2_16::RSEncode);
+  for (auto _ : state) {
+    auto failed = gf_2_16::RSDecodeBatch(codewords.data(), n, parity, batch);
+    benchmark::DoNotOptimize(failed);
+  }
+  state.SetBytesProcessed(state.iterations() * n * batch * 2);
+}
+
+static void BM_RSDecodeErrors_2_16(benchmark::State &state) {
+  size_t n = 1024;
+  size_t parity = state.range(0);
+  size_t batch = state.range(1);
+  std::mt19937_64 rng(42);
+  gf_2_8::Init();
+
+  auto ref = RandomCodewords<gf_2_16::element_t>(n, parity, batch, rng,
+                                                 gf_2_16::RSEncode);
+  auto codewords = ref;
+  for (auto _ : state) {
+    state.PauseTiming();
+    codewords = ref;
+    AddErrors(codewords, n, batch, parity / 2, rng);
+    state.ResumeTiming();
+    auto failed = gf_2_16::RSDecodeBatch(codewords.data(), n, parity, batch);
+    benchmark::DoNotOptimize(failed);
+  }
+  state.SetBytesProcessed(state.iterations() * n * batch * 2);
+}
+
+BENCHMARK(BM_RSDecodeClean_2_8)
+    ->Name("RSDecodeClean_2_8")
+    ->ArgNames({"parity", "batch"})
+    ->ArgsProduct({{4, 16, 32}, {64, 1024}});
+
+BENCHMARK(BM_RSDecodeErrors_2_8)
+    ->Name("RSDecodeErrors_2_8")
+    ->ArgNames({"parity", "batch"})
+    ->ArgsProduct({{4, 16, 32}, {64, 1024}});
+
+BENCHMARK(BM_RSDecodeClean_2_16)
+    ->Name("RSDecodeClean_2_16")
+    ->ArgNames({"parity", "batch"})
+    ->ArgsProduct({{4, 16, 32}, {64, 1024}});
+
+BENCHMARK(BM_RSDecodeErrors_2_16)
+    ->Name("RSDecodeErrors_2_16")
+    ->ArgNames({"parity", "batch"})
+    ->ArgsProduct({{4, 16, 32}, {64, 1024}});
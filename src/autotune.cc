@@ -0,0 +1,255 @@
+#include "autotune.h"
+#include "gf256/gf256.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <tuple>
+#include <vector>
+
+namespace gf_2_8 {
+
+namespace {
+
+typedef void (*RowKernelFunction)(element_t *, const element_t *, element_t,
+                                  size_t);
+
+/**
+ * Dimensions of shape class are log2 of dimensions rounded up
+ */
+typedef std::tuple<size_t, size_t, size_t> ShapeClass;
+
+const char *kernel_names[] = {"base", "simd", "gfni_general",
+                              "gfni_dedicated"};
+
+const RowKernelFunction kernel_functions[] = {
+    AddScaledRowBase, AddScaledRowSIMD, AddScaledRowGFNIGeneral,
+    AddScaledRowGFNIDedicated};
+
+/**
+ * Column tiles of MatMulStreaming tried by Autotune besides untiled MatMul
+ */
+const size_t tile_candidates[] = {1024, 4096, 16384};
+
+/**
+ * Upper bound on m_i * m_k * m_j of matrices multiplied while tuning.
+ * Rows of result are computed independently, so m_i is reduced for large
+ * shapes. Column tiles pay off by reusing each tile of right for many
+ * rows, so they are compared on at least tile_reuse_rows rows.
+ */
+constexpr size_t tuning_budget = size_t(1) << 26;
+constexpr size_t tile_reuse_rows = 64;
+
+/**
+ * Each candidate is run at least this long and this many times, unless
+ * its runs already took tuning_limit
+ */
+constexpr std::chrono::milliseconds tuning_time(20);
+constexpr std::chrono::milliseconds tuning_limit(200);
+constexpr size_t tuning_runs = 3;
+
+std::mutex mutex;
+std::map<ShapeClass, TuningConfig> cache;
+std::string tuning_file;
+
+ShapeClass Classify(size_t m_i, size_t m_k, size_t m_j) {
+  auto log = [](size_t d) -> size_t { return std::bit_width(d ? d - 1 : 0); };
+  return {log(m_i), log(m_k), log(m_j)};
+}
+
+void InitKernels() {
+  static std::once_flag once;
+  std::call_once(once, [] {
+    Init();
+    InitGFNI();
+    gf256_init();
+  });
+}
+
+TuningConfig DefaultConfig() {
+  TuningConfig config;
+#if defined(__GFNI__) and defined(__AVX512F__)
+  config.kernel = RowKernel::kGFNIDedicated;
+#else
+  config.kernel = RowKernel::kSIMD;
+#endif
+  return config;
+}
+
+void Run(const TuningConfig &config, const element_t *left,
+         const element_t *right, size_t m_i, size_t m_k, size_t m_j,
+         element_t *result) {
+  auto fma = kernel_functions[static_cast<size_t>(config.kernel)];
+  if (config.tile_columns == 0 || config.tile_columns >= m_j) {
+    MatMul(left, right, m_i, m_k, m_j, fma, result);
+    return;
+  }
+  StreamingParams params;
+  params.tile_columns = config.tile_columns;
+  MatMulStreaming(left, right, m_i, m_k, m_j, fma, params, result);
+}
+
+/**
+ * Writes tuning cache, caller must hold the mutex
+ */
+bool Save() {
+  std::ofstream out(tuning_file);
+  if (!out) {
+    return false;
+  }
+  out << "# log2(m_i) log2(m_k) log2(m_j) kernel tile_columns\n";
+  for (const auto &[shape, config] : cache) {
+    out << std::get<0>(shape) << ' ' << std::get<1>(shape) << ' '
+        << std::get<2>(shape) << ' '
+        << kernel_names[static_cast<size_t>(config.kernel)] << ' '
+        << config.tile_columns << '\n';
+  }
+  return static_cast<bool>(out);
+}
+
+/**
+ * Returns fastest of @p candidates on given matrices, each candidate is
+ * run at least tuning_runs times and tuning_time long but stops after
+ * tuning_limit
+ */
+TuningConfig Fastest(const std::vector<TuningConfig> &candidates,
+                     const element_t *left, const element_t *right,
+                     size_t m_i, size_t m_k, size_t m_j, element_t *result) {
+  TuningConfig best = candidates.front();
+  auto best_time = std::chrono::steady_clock::duration::max();
+  for (const auto &config : candidates) {
+    auto fastest = std::chrono::steady_clock::duration::max();
+    auto start = std::chrono::steady_clock::now();
+    for (size_t run = 0;; ++run) {
+      auto elapsed = std::chrono::steady_clock::now() - start;
+      if (run > 0 && (elapsed >= tuning_limit ||
+                      (run >= tuning_runs && elapsed >= tuning_time))) {
+        break;
+      }
+      auto run_start = std::chrono::steady_clock::now();
+      Run(config, left, right, m_i, m_k, m_j, result);
+      fastest = std::min(fastest, std::chrono::steady_clock::now() - run_start);
+    }
+    if (fastest < best_time) {
+      best_time = fastest;
+      best = config;
+    }
+  }
+  return best;
+}
+
+} // namespace
+
+TuningConfig Autotune(size_t m_i, size_t m_k, size_t m_j) {
+  InitKernels();
+  auto shape = Classify(m_i, m_k, m_j);
+  size_t i = size_t(1) << std::get<0>(shape);
+  size_t k = size_t(1) << std::get<1>(shape);
+  size_t j = size_t(1) << std::get<2>(shape);
+  size_t kernel_i = std::clamp<size_t>(tuning_budget / (k * j), 1, i);
+  size_t tile_i = std::clamp<size_t>(tuning_budget / (k * j),
+                                     std::min(tile_reuse_rows, i), i);
+
+  std::mt19937_64 rng(42);
+  std::vector<element_t> left(tile_i * k), right(k * j), result(tile_i * j);
+  for (auto &x : left) {
+    x = rng();
+  }
+  for (auto &x : right) {
+    x = rng();
+  }
+
+  std::vector<TuningConfig> candidates;
+  for (size_t kernel = 0; kernel < std::size(kernel_functions); ++kernel) {
+    TuningConfig config;
+    config.kernel = static_cast<RowKernel>(kernel);
+    candidates.push_back(config);
+  }
+  TuningConfig best = Fastest(candidates, left.data(), right.data(), kernel_i,
+                              k, j, result.data());
+
+  candidates = {best};
+  for (auto tile : tile_candidates) {
+    if (tile < j) {
+      candidates.push_back({best.kernel, tile});
+    }
+  }
+  if (candidates.size() > 1) {
+    best = Fastest(candidates, left.data(), right.data(), tile_i, k, j,
+                   result.data());
+  }
+
+  std::lock_guard lock(mutex);
+  cache[shape] = best;
+  if (!tuning_file.empty()) {
+    Save();
+  }
+  return best;
+}
+
+TuningConfig TunedConfig(size_t m_i, size_t m_k, size_t m_j) {
+  {
+    std::lock_guard lock(mutex);
+    auto it = cache.find(Classify(m_i, m_k, m_j));
+    if (it != cache.end()) {
+      return it->second;
+    }
+    if (tuning_file.empty()) {
+      return DefaultConfig();
+    }
+  }
+  return Autotune(m_i, m_k, m_j);
+}
+
+bool SetTuningFile(const std::string &path) {
+  // File is parsed completely before anything is changed, so a rejected
+  // file is neither partially loaded nor overwritten by further tuning
+  std::map<ShapeClass, TuningConfig> loaded;
+  std::ifstream in(path);
+  std::string line;
+  while (in && std::getline(in, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::istringstream fields(line);
+    size_t i, k, j;
+    std::string kernel;
+    TuningConfig config;
+    if (!(fields >> i >> k >> j >> kernel >> config.tile_columns)) {
+      return false;
+    }
+    auto name = std::find(std::begin(kernel_names), std::end(kernel_names),
+                          kernel);
+    if (name == std::end(kernel_names)) {
+      return false;
+    }
+    config.kernel = static_cast<RowKernel>(name - std::begin(kernel_names));
+    loaded[{i, k, j}] = config;
+  }
+
+  std::lock_guard lock(mutex);
+  tuning_file = path;
+  for (const auto &[shape, config] : loaded) {
+    cache[shape] = config;
+  }
+  return true;
+}
+
+void ResetTuning() {
+  std::lock_guard lock(mutex);
+  cache.clear();
+  tuning_file.clear();
+}
+
+void MatMulTuned(const element_t *left, const element_t *right, size_t m_i,
+                 size_t m_k, size_t m_j, element_t *result) {
+  InitKernels();
+  Run(TunedConfig(m_i, m_k, m_j), left, right, m_i, m_k, m_j, result);
+}
+
+} // namespace gf_2_8
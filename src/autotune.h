@@ -0,0 +1,86 @@
+#pragma once
+
+#include "field.h"
+
+#include <cstddef>
+#include <string>
+
+/**
+ * Autotuning of GF(256) matrix multiplication.
+ *
+ * Best row kernel and tiling depend on CPU and matrix shape, so they are
+ * measured on the running machine for shape classes, i.e. (m_i, m_k, m_j)
+ * with every dimension rounded up to a power of two, and kept in a tuning
+ * cache that can be persisted to a local file.
+ */
+namespace gf_2_8 {
+
+/**
+ * Row kernels available to tuned matrix multiplication
+ */
+enum class RowKernel {
+  kBase,
+  kSIMD,
+  kGFNIGeneral,
+  kGFNIDedicated,
+};
+
+/**
+ * Matrix multiplication configuration for a shape class
+ */
+struct TuningConfig {
+  RowKernel kernel = RowKernel::kGFNIDedicated;
+  /**
+   * Column tile of MatMulStreaming, 0 means untiled MatMul
+   */
+  size_t tile_columns = 0;
+};
+
+/**
+ * @brief Measures candidate configurations for shape class of
+ * (m_i, m_k, m_j)
+ * @details
+ * Every row kernel is tried with untiled MatMul on a reduced number of
+ * rows, then the fastest one is tried with several column tiles of
+ * MatMulStreaming on enough rows to reuse each tile. The fastest
+ * configuration is stored in the tuning cache and written to tuning file
+ * if it was set.
+ * @return The fastest configuration
+ */
+TuningConfig Autotune(size_t m_i, size_t m_k, size_t m_j);
+
+/**
+ * @brief Configuration for shape class of (m_i, m_k, m_j)
+ * @details
+ * Returns cached configuration. On cache miss the shape class is tuned
+ * with Autotune if tuning file is set, otherwise default configuration
+ * is returned.
+ */
+TuningConfig TunedConfig(size_t m_i, size_t m_k, size_t m_j);
+
+/**
+ * @brief Sets local tuning file
+ * @details
+ * Loads configurations stored in @p path into tuning cache, the file may
+ * not exist yet. Configurations found by further tuning are written to
+ * the file, so each shape class is measured once per machine.
+ * @return false if file exists but could not be parsed, in that case
+ * tuning cache and tuning file are left unchanged
+ */
+bool SetTuningFile(const std::string &path);
+
+/**
+ * @brief Clears tuning cache and unsets tuning file
+ */
+void ResetTuning();
+
+/**
+ * @brief Matrix multiplication with tuned configuration
+ * @details
+ * Same as MatMul, row kernel and tiling are taken from TunedConfig.
+ * Initializes tables required by the kernels.
+ */
+void MatMulTuned(const element_t *left, const element_t *right, size_t m_i,
+                 size_t m_k, size_t m_j, element_t *result);
+
+} // namespace gf_2_8
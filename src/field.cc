@@ -1,6 +1,7 @@
 #include "field.h"
 #include "gf256/gf256.h"
 
+#include <algorithm>
 #include <cstring>
 #include <immintrin.h>
 
@@ -62,7 +63,7 @@ void InitGFNI(void) {
 
     for (size_t i = 0; i < 8; ++i) {
       for (size_t j = 0; j < 8; ++j) {
-        gfni_matrix[y] |= ((mt >> (8 * i + j)) & 1) << (8 * j + (7 - i));
+        gfni_matrix[y] |= ((mt >> (8 * i + j)) & 1) << (8 * (7 - j) + i);
       }
     }
   }
@@ -215,6 +216,81 @@ void AddScaledRowGFNIDedicated(element_t *x, const element_t *y, element_t z,
   AddScaledRowBase(x, y, z, length - processed);
 }
 
+/**
+ * Requests @p length bytes starting from @p row into cache
+ */
+static void PrefetchRow(const element_t *row, size_t length) {
+  for (size_t offset = 0; offset < length; offset += 64) {
+    _mm_prefetch(reinterpret_cast<const char *>(row + offset), _MM_HINT_T0);
+  }
+}
+
+/**
+ * Copies @p length bytes from @p src to @p dst with non-temporal stores,
+ * so that lines of @p dst are written to memory without being read
+ */
+static void StreamRow(element_t *dst, const element_t *src, size_t length) {
+  // Streaming stores require aligned destination, partial lines at the
+  // ends are copied with regular stores
+  size_t head = (64 - reinterpret_cast<uintptr_t>(dst) % 64) % 64;
+  head = std::min(head, length);
+  std::memcpy(dst, src, head);
+  size_t processed = head;
+#if defined(__AVX512F__)
+  for (; processed + 64 <= length; processed += 64) {
+    _mm512_stream_si512(reinterpret_cast<__m512i *>(dst + processed),
+                        _mm512_loadu_si512(src + processed));
+  }
+#else
+  for (; processed + 16 <= length; processed += 16) {
+    _mm_stream_si128(
+        reinterpret_cast<__m128i *>(dst + processed),
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + processed)));
+  }
+#endif
+  std::memcpy(dst + processed, src + processed, length - processed);
+}
+
+void MatMulStreaming(
+    const element_t *left, const element_t *right, size_t m_i, size_t m_k,
+    size_t m_j,
+    std::function<void(element_t *, const element_t *, element_t, size_t)> fma,
+    const StreamingParams &params, element_t *result) {
+  size_t tile = std::max<size_t>(params.tile_columns, 64);
+  // Result tile row is accumulated here and streamed to result once, so
+  // result is never read into cache
+  std::vector<element_t> scratch(params.non_temporal ? tile : 0);
+  for (size_t jb = 0; jb < m_j; jb += tile) {
+    size_t width = std::min(tile, m_j - jb);
+    size_t next_width = std::min(tile, m_j - std::min(m_j, jb + tile));
+    for (size_t i = 0; i < m_i; ++i) {
+      element_t *result_row = result + i * m_j + jb;
+      element_t *row = params.non_temporal ? scratch.data() : result_row;
+      std::memset(row, 0, width);
+      for (size_t k = 0; k < m_k; ++k) {
+        // Tile of right comes from memory on the first row only, segments
+        // past the end of the tile belong to the next one
+        if (i == 0 && params.prefetch_rows > 0) {
+          size_t ahead = k + params.prefetch_rows;
+          if (ahead < m_k) {
+            PrefetchRow(right + ahead * m_j + jb, width);
+          } else if (ahead - m_k < m_k) {
+            PrefetchRow(right + (ahead - m_k) * m_j + jb + width, next_width);
+          }
+        }
+        fma(row, right + k * m_j + jb, left[i * m_k + k], width);
+      }
+      if (params.non_temporal) {
+        StreamRow(result_row, row, width);
+      }
+    }
+  }
+  if (params.non_temporal) {
+    // Orders non-temporal stores before subsequent stores
+    _mm_sfence();
+  }
+}
+
 void MatMul(
     const element_t *left, const element_t *right, size_t m_i, size_t m_k,
     size_t m_j,
@@ -230,6 +306,217 @@ void MatMul(
   }
 }
 
+/**
+ * Side of square block processed by Transpose at once, 64x64 bytes
+ * are 4KiB for source and destination each
+ */
+constexpr size_t transpose_block = 64;
+
+/**
+ * Size of right operand rows buffer used by MatMul with column-major
+ * right operand
+ */
+constexpr size_t transpose_buffer_bytes = 1 << 17;
+
+/**
+ * Transposes 8x8 tile of @p src with row stride @p src_stride into
+ * @p dst with row stride @p dst_stride
+ */
+static void TransposeTile8x8(const element_t *src, size_t src_stride,
+                             element_t *dst, size_t dst_stride) {
+#if defined(__AVX512VBMI__)
+  // Byte r * 8 + c of the loaded tile goes to c * 8 + r
+  alignas(64) static const uint8_t permutation[64] = {
+      0, 8, 16, 24, 32, 40, 48, 56,
+      1, 9, 17, 25, 33, 41, 49, 57,
+      2, 10, 18, 26, 34, 42, 50, 58,
+      3, 11, 19, 27, 35, 43, 51, 59,
+      4, 12, 20, 28, 36, 44, 52, 60,
+      5, 13, 21, 29, 37, 45, 53, 61,
+      6, 14, 22, 30, 38, 46, 54, 62,
+      7, 15, 23, 31, 39, 47, 55, 63,
+  };
+  // Rows are gathered in registers, a memory buffer read back with one
+  // wide load would stall on store forwarding
+  __m128i pairs[4];
+  for (size_t p = 0; p < 4; ++p) {
+    pairs[p] = _mm_unpacklo_epi64(
+        _mm_loadl_epi64((const __m128i *)(src + 2 * p * src_stride)),
+        _mm_loadl_epi64((const __m128i *)(src + (2 * p + 1) * src_stride)));
+  }
+  auto tile = _mm512_inserti64x4(
+      _mm512_castsi256_si512(_mm256_set_m128i(pairs[1], pairs[0])),
+      _mm256_set_m128i(pairs[3], pairs[2]), 1);
+  tile = _mm512_permutexvar_epi8(_mm512_load_si512(permutation), tile);
+  __m128i columns[4] = {
+      _mm512_extracti32x4_epi32(tile, 0), _mm512_extracti32x4_epi32(tile, 1),
+      _mm512_extracti32x4_epi32(tile, 2), _mm512_extracti32x4_epi32(tile, 3)};
+#elif defined(__SSE2__)
+  __m128i rows[8];
+  for (size_t r = 0; r < 8; ++r) {
+    rows[r] = _mm_loadl_epi64((const __m128i *)(src + r * src_stride));
+  }
+  // Interleaving bytes, words and double words of row pairs yields
+  // columns of 2, 4 and 8 rows
+  __m128i bytes[4], words[4];
+  for (size_t p = 0; p < 4; ++p) {
+    bytes[p] = _mm_unpacklo_epi8(rows[2 * p], rows[2 * p + 1]);
+  }
+  for (size_t p = 0; p < 2; ++p) {
+    words[2 * p] = _mm_unpacklo_epi16(bytes[2 * p], bytes[2 * p + 1]);
+    words[2 * p + 1] = _mm_unpackhi_epi16(bytes[2 * p], bytes[2 * p + 1]);
+  }
+  __m128i columns[4] = {_mm_unpacklo_epi32(words[0], words[2]),
+                        _mm_unpackhi_epi32(words[0], words[2]),
+                        _mm_unpacklo_epi32(words[1], words[3]),
+                        _mm_unpackhi_epi32(words[1], words[3])};
+#endif
+#if defined(__AVX512VBMI__) or defined(__SSE2__)
+  // Each register holds two columns of the tile, i.e. two rows of dst
+  for (size_t p = 0; p < 4; ++p) {
+    _mm_storel_epi64((__m128i *)(dst + 2 * p * dst_stride), columns[p]);
+    _mm_storeh_pd((double *)(dst + (2 * p + 1) * dst_stride),
+                  _mm_castsi128_pd(columns[p]));
+  }
+#else
+  for (size_t r = 0; r < 8; ++r) {
+    for (size_t c = 0; c < 8; ++c) {
+      dst[c * dst_stride + r] = src[r * src_stride + c];
+    }
+  }
+#endif
+}
+
+/**
+ * Transposes rows*cols submatrix of @p src with row stride @p src_stride
+ * into @p dst with row stride @p dst_stride
+ */
+static void TransposeStrided(const element_t *src, size_t src_stride,
+                             size_t rows, size_t cols, element_t *dst,
+                             size_t dst_stride) {
+  for (size_t rb = 0; rb < rows; rb += transpose_block) {
+    size_t r_end = std::min(rows, rb + transpose_block);
+    for (size_t cb = 0; cb < cols; cb += transpose_block) {
+      size_t c_end = std::min(cols, cb + transpose_block);
+      size_t r = rb;
+      for (; r + 8 <= r_end; r += 8) {
+        size_t c = cb;
+        for (; c + 8 <= c_end; c += 8) {
+          TransposeTile8x8(src + r * src_stride + c, src_stride,
+                           dst + c * dst_stride + r, dst_stride);
+        }
+        for (; c < c_end; ++c) {
+          for (size_t t = r; t < r + 8; ++t) {
+            dst[c * dst_stride + t] = src[t * src_stride + c];
+          }
+        }
+      }
+      for (; r < r_end; ++r) {
+        for (size_t c = cb; c < c_end; ++c) {
+          dst[c * dst_stride + r] = src[r * src_stride + c];
+        }
+      }
+    }
+  }
+}
+
+void Transpose(const element_t *src, size_t rows, size_t cols,
+               element_t *dst) {
+  TransposeStrided(src, cols, rows, cols, dst, rows);
+}
+
+void MatMul(
+    const element_t *left, Layout left_layout, const element_t *right,
+    Layout right_layout, size_t m_i, size_t m_k, size_t m_j,
+    std::function<void(element_t *, const element_t *, element_t, size_t)> fma,
+    element_t *result) {
+  // Strides of left along i and k
+  size_t left_i = left_layout == Layout::kRowMajor ? m_k : 1;
+  size_t left_k = left_layout == Layout::kRowMajor ? 1 : m_i;
+
+  if (right_layout == Layout::kRowMajor) {
+    std::memset(result, 0, m_i * m_j);
+    for (size_t i = 0; i < m_i; ++i, result += m_j) {
+      auto right_row = right;
+      for (size_t k = 0; k < m_k; ++k, right_row += m_j) {
+        fma(result, right_row, left[i * left_i + k * left_k], m_j);
+      }
+    }
+    return;
+  }
+
+  // Right is stored as m_j*m_k, rows of block [kb, kb + block) are
+  // transposed into buffer and consumed while they are in cache
+  size_t block = std::max<size_t>(8, transpose_buffer_bytes / (m_j + 1));
+  block = std::min(block, m_k);
+  std::vector<element_t> rows(block * m_j);
+  std::memset(result, 0, m_i * m_j);
+  for (size_t kb = 0; kb < m_k; kb += block) {
+    size_t k_end = std::min(m_k, kb + block);
+    TransposeStrided(right + kb, m_k, m_j, k_end - kb, rows.data(), m_j);
+    auto result_row = result;
+    for (size_t i = 0; i < m_i; ++i, result_row += m_j) {
+      auto right_row = rows.data();
+      for (size_t k = kb; k < k_end; ++k, right_row += m_j) {
+        fma(result_row, right_row, left[i * left_i + k * left_k], m_j);
+      }
+    }
+  }
+}
+
+void AddRow(element_t *x, const element_t *y, size_t length) {
+  size_t processed = 0;
+#if defined(__AVX512F__)
+  while (processed + 64 <= length) {
+    auto x_reg = _mm512_loadu_si512(x);
+    auto y_reg = _mm512_loadu_si512(y);
+    _mm512_storeu_si512(x, _mm512_xor_si512(x_reg, y_reg));
+    x += 64;
+    y += 64;
+    processed += 64;
+  }
+#endif
+  for (; processed < length; ++processed) {
+    *x++ ^= *y++;
+  }
+}
+
+SparseMatrix ToSparse(const element_t *matrix, size_t m_i, size_t m_k) {
+  SparseMatrix sparse;
+  sparse.rows = m_i;
+  sparse.cols = m_k;
+  sparse.row_offsets.reserve(m_i + 1);
+  sparse.row_offsets.push_back(0);
+  for (size_t i = 0; i < m_i; ++i) {
+    for (size_t k = 0; k < m_k; ++k, ++matrix) {
+      if (*matrix != 0) {
+        sparse.columns.push_back(k);
+        sparse.values.push_back(*matrix);
+      }
+    }
+    sparse.row_offsets.push_back(sparse.columns.size());
+  }
+  return sparse;
+}
+
+void SparseMatMul(
+    const SparseMatrix &left, const element_t *right, size_t m_j,
+    std::function<void(element_t *, const element_t *, element_t, size_t)> fma,
+    element_t *result) {
+  std::memset(result, 0, left.rows * m_j);
+  for (size_t i = 0; i < left.rows; ++i) {
+    for (size_t p = left.row_offsets[i]; p < left.row_offsets[i + 1]; ++p) {
+      const element_t *right_row = right + left.columns[p] * m_j;
+      if (left.values[p] == 1) {
+        AddRow(result, right_row, m_j);
+      } else {
+        fma(result, right_row, left.values[p], m_j);
+      }
+    }
+    result += m_j;
+  }
+}
+
 } // namespace gf_2_8
 
 namespace gf_2_16 {
@@ -295,3 +582,298 @@ element_t InvIT(element_t a) {
 }
 
 } // namespace gf_2_16
+
+namespace {
+
+/**
+ * Carry-less product of @p a and @p b, low 64 bits are returned,
+ * high 64 bits are put into @p high
+ */
+uint64_t CarrylessMultiply(uint64_t a, uint64_t b, uint64_t *high) {
+#if defined(__PCLMUL__) and defined(__SSE4_1__)
+  __m128i product =
+      _mm_clmulepi64_si128(_mm_cvtsi64_si128(a), _mm_cvtsi64_si128(b), 0);
+  *high = _mm_extract_epi64(product, 1);
+  return _mm_cvtsi128_si64(product);
+#else
+  uint64_t low = 0;
+  *high = 0;
+  for (size_t i = 0; i < 64; ++i) {
+    if ((b >> i) & 1) {
+      low ^= a << i;
+      *high ^= i ? a >> (64 - i) : 0;
+    }
+  }
+  return low;
+#endif
+}
+
+/**
+ * Quotient of polynomial division of @p a by @p b
+ */
+constexpr uint64_t PolynomialDiv(uint64_t a, uint64_t b) {
+  uint64_t quotient = 0;
+  int b_degree = 63 - __builtin_clzll(b);
+  for (int shift = 63 - b_degree; shift >= 0; --shift) {
+    if ((a >> (shift + b_degree)) & 1) {
+      a ^= b << shift;
+      quotient |= uint64_t(1) << shift;
+    }
+  }
+  return quotient;
+}
+
+/**
+ * Low 64 bits of carry-less product
+ */
+constexpr uint64_t PolynomialMul(uint64_t a, uint64_t b) {
+  uint64_t result = 0;
+  for (size_t i = 0; i < 64; ++i) {
+    if ((b >> i) & 1) {
+      result ^= a << i;
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+namespace gf_2_32 {
+
+/**
+ * Irreducible polynomial defining the field without x^32 term
+ */
+const element_t irreducible_poly = 0x400007; // x^22+x^2+x+1
+
+/**
+ * Barrett constant floor(x^64 / P) without x^32 term. For
+ * P = x^32 + p we have x^64 = P * (x^32 + p) + p^2, so the constant
+ * is p + floor(p^2 / P).
+ */
+constexpr uint64_t barrett_constant =
+    irreducible_poly ^
+    PolynomialDiv(PolynomialMul(irreducible_poly, irreducible_poly),
+                  (uint64_t(1) << 32) | irreducible_poly);
+
+element_t Zero() { return 0; }
+
+element_t One() { return 1; }
+
+element_t Add(element_t a, element_t b) { return a ^ b; }
+
+element_t Sub(element_t a, element_t b) { return a ^ b; }
+
+element_t Multiply(element_t a, element_t b) {
+  element_t result = 0;
+  while (a) {
+    result ^= b * (a & 1);
+    a >>= 1;
+    b = (b << 1) ^ (irreducible_poly * (b >> 31));
+  }
+  return result;
+}
+
+element_t MultiplyCLMUL(element_t a, element_t b) {
+  uint64_t high;
+  uint64_t product = CarrylessMultiply(a, b, &high);
+  // product = h * x^32 + l, quotient q = floor(h * (x^32 + m) / x^32)
+  uint64_t h = product >> 32;
+  uint64_t q = h ^ (CarrylessMultiply(h, barrett_constant, &high) >> 32);
+  return product ^ CarrylessMultiply(q, irreducible_poly, &high);
+}
+
+element_t Pow(element_t a, uint64_t n) {
+  element_t result = One();
+  while (n) {
+    if (n & 1) {
+      result = MultiplyCLMUL(result, a);
+    }
+    a = MultiplyCLMUL(a, a);
+    n >>= 1;
+  }
+  return result;
+}
+
+element_t Inv(element_t a) { return Pow(a, 0xfffffffe); }
+
+element_t Div(element_t a, element_t b) { return MultiplyCLMUL(a, Inv(b)); }
+
+void AddScaledRowBase(element_t *x, const element_t *y, element_t z,
+                      size_t length) {
+  if (z == 0) {
+    return;
+  }
+  for (size_t i = 0; i < length; ++i) {
+    x[i] ^= MultiplyCLMUL(y[i], z);
+  }
+}
+
+void AddScaledRowCLMUL(element_t *x, const element_t *y, element_t z,
+                       size_t length) {
+  if (z == 0) {
+    return;
+  }
+  size_t processed = 0;
+#if defined(__VPCLMULQDQ__) and defined(__AVX512F__)
+  __m512i z_reg = _mm512_set1_epi64(z);
+  __m512i barrett = _mm512_set1_epi64(barrett_constant);
+  __m512i poly = _mm512_set1_epi64(irreducible_poly);
+  while (processed + 8 <= length) {
+    // Each element occupies its own 64-bit lane, products fit into it
+    __m512i y_reg = _mm512_cvtepu32_epi64(_mm256_loadu_si256((__m256i *)y));
+    __m512i product = _mm512_unpacklo_epi64(
+        _mm512_clmulepi64_epi128(y_reg, z_reg, 0x00),
+        _mm512_clmulepi64_epi128(y_reg, z_reg, 0x01));
+    __m512i h = _mm512_srli_epi64(product, 32);
+    __m512i q = _mm512_xor_si512(
+        h, _mm512_srli_epi64(
+               _mm512_unpacklo_epi64(_mm512_clmulepi64_epi128(h, barrett, 0x00),
+                                     _mm512_clmulepi64_epi128(h, barrett, 0x01)),
+               32));
+    product = _mm512_xor_si512(
+        product,
+        _mm512_unpacklo_epi64(_mm512_clmulepi64_epi128(q, poly, 0x00),
+                              _mm512_clmulepi64_epi128(q, poly, 0x01)));
+    __m256i x_reg = _mm256_loadu_si256((__m256i *)x);
+    x_reg = _mm256_xor_si256(x_reg, _mm512_cvtepi64_epi32(product));
+    _mm256_storeu_si256((__m256i *)x, x_reg);
+    x += 8;
+    y += 8;
+    processed += 8;
+  }
+#endif
+  AddScaledRowBase(x, y, z, length - processed);
+}
+
+void MatMul(
+    const element_t *left, const element_t *right, size_t m_i, size_t m_k,
+    size_t m_j,
+    std::function<void(element_t *, const element_t *, element_t, size_t)> fma,
+    element_t *result) {
+  std::memset(result, 0, m_i * m_j * sizeof(element_t));
+  for (size_t i = 0; i < m_i; ++i) {
+    auto right_row = right;
+    for (size_t k = 0; k < m_k; ++k, left++, right_row += m_j) {
+      fma(result, right_row, *left, m_j);
+    }
+    result += m_j;
+  }
+}
+
+} // namespace gf_2_32
+
+namespace gf_2_64 {
+
+/**
+ * Irreducible polynomial defining the field without x^64 term
+ */
+const element_t irreducible_poly = 0x1b; // x^4+x^3+x+1
+
+/**
+ * Barrett constant floor(x^128 / P) without x^64 term. For
+ * P = x^64 + p we have x^128 = P * (x^64 + p) + p^2 and p^2 has degree
+ * below 64, so the constant is p itself.
+ */
+const element_t barrett_constant = irreducible_poly;
+
+element_t Zero() { return 0; }
+
+element_t One() { return 1; }
+
+element_t Add(element_t a, element_t b) { return a ^ b; }
+
+element_t Sub(element_t a, element_t b) { return a ^ b; }
+
+element_t Multiply(element_t a, element_t b) {
+  element_t result = 0;
+  while (a) {
+    result ^= b * (a & 1);
+    a >>= 1;
+    b = (b << 1) ^ (irreducible_poly * (b >> 63));
+  }
+  return result;
+}
+
+element_t MultiplyCLMUL(element_t a, element_t b) {
+  uint64_t h, high;
+  uint64_t l = CarrylessMultiply(a, b, &h);
+  // product = h * x^64 + l, quotient q = floor(h * (x^64 + m) / x^64)
+  CarrylessMultiply(h, barrett_constant, &high);
+  uint64_t q = h ^ high;
+  return l ^ CarrylessMultiply(q, irreducible_poly, &high);
+}
+
+element_t Pow(element_t a, uint64_t n) {
+  element_t result = One();
+  while (n) {
+    if (n & 1) {
+      result = MultiplyCLMUL(result, a);
+    }
+    a = MultiplyCLMUL(a, a);
+    n >>= 1;
+  }
+  return result;
+}
+
+element_t Inv(element_t a) { return Pow(a, 0xfffffffffffffffe); }
+
+element_t Div(element_t a, element_t b) { return MultiplyCLMUL(a, Inv(b)); }
+
+void AddScaledRowBase(element_t *x, const element_t *y, element_t z,
+                      size_t length) {
+  if (z == 0) {
+    return;
+  }
+  for (size_t i = 0; i < length; ++i) {
+    x[i] ^= MultiplyCLMUL(y[i], z);
+  }
+}
+
+void AddScaledRowCLMUL(element_t *x, const element_t *y, element_t z,
+                       size_t length) {
+  if (z == 0) {
+    return;
+  }
+  size_t processed = 0;
+#if defined(__VPCLMULQDQ__) and defined(__AVX512F__)
+  __m512i z_reg = _mm512_set1_epi64(z);
+  __m512i barrett = _mm512_set1_epi64(barrett_constant);
+  __m512i poly = _mm512_set1_epi64(irreducible_poly);
+  while (processed + 8 <= length) {
+    __m512i y_reg = _mm512_loadu_si512(y);
+    // 128-bit products of even and odd elements
+    __m512i even = _mm512_clmulepi64_epi128(y_reg, z_reg, 0x00);
+    __m512i odd = _mm512_clmulepi64_epi128(y_reg, z_reg, 0x01);
+    __m512i l = _mm512_unpacklo_epi64(even, odd);
+    __m512i h = _mm512_unpackhi_epi64(even, odd);
+    __m512i q = _mm512_xor_si512(
+        h, _mm512_unpackhi_epi64(_mm512_clmulepi64_epi128(h, barrett, 0x00),
+                                 _mm512_clmulepi64_epi128(h, barrett, 0x01)));
+    l = _mm512_xor_si512(
+        l, _mm512_unpacklo_epi64(_mm512_clmulepi64_epi128(q, poly, 0x00),
+                                 _mm512_clmulepi64_epi128(q, poly, 0x01)));
+    _mm512_storeu_si512(x, _mm512_xor_si512(_mm512_loadu_si512(x), l));
+    x += 8;
+    y += 8;
+    processed += 8;
+  }
+#endif
+  AddScaledRowBase(x, y, z, length - processed);
+}
+
+void MatMul(
+    const element_t *left, const element_t *right, size_t m_i, size_t m_k,
+    size_t m_j,
+    std::function<void(element_t *, const element_t *, element_t, size_t)> fma,
+    element_t *result) {
+  std::memset(result, 0, m_i * m_j * sizeof(element_t));
+  for (size_t i = 0; i < m_i; ++i) {
+    auto right_row = right;
+    for (size_t k = 0; k < m_k; ++k, left++, right_row += m_j) {
+      fma(result, right_row, *left, m_j);
+    }
+    result += m_j;
+  }
+}
+
+} // namespace gf_2_64
@@ -3,6 +3,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <vector>
 
 /**
  * GF(256) field implementation using polynomial representation
@@ -151,6 +152,117 @@ void MatMul(
     std::function<void(element_t *, const element_t *, element_t, size_t)> fma,
     element_t *result);
 
+/**
+ * Tuning parameters of MatMulStreaming
+ */
+struct StreamingParams {
+  /**
+   * Number of columns of right and result processed at once, tile of
+   * right is m_k*tile_columns bytes and should fit into L2 cache
+   */
+  size_t tile_columns = 4096;
+  /**
+   * How many row segments of right ahead of the current one are software
+   * prefetched, 0 disables prefetching
+   */
+  size_t prefetch_rows = 4;
+  /**
+   * Accumulate each result tile row in a buffer of tile_columns bytes,
+   * which should fit into L1 cache, and write it to result with
+   * non-temporal stores, so result is never read into cache
+   */
+  bool non_temporal = false;
+};
+
+/**
+ * @brief MatMul for matrices that do not fit into cache
+ * @details
+ * Computes the same product as MatMul, but splits @p right and @p result
+ * into column tiles of params.tile_columns, so each tile of @p right is
+ * loaded from memory once and reused for all rows of @p left. Upcoming
+ * segments of @p right are prefetched and result is optionally written
+ * with non-temporal stores according to @p params.
+ */
+void MatMulStreaming(
+    const element_t *left, const element_t *right, size_t m_i, size_t m_k,
+    size_t m_j,
+    std::function<void(element_t *, const element_t *, element_t, size_t)> fma,
+    const StreamingParams &params, element_t *result);
+
+/**
+ * Memory layout of a matrix operand
+ */
+enum class Layout {
+  kRowMajor,
+  kColMajor,
+};
+
+/**
+ * @brief MatMul over operands in arbitrary layout
+ * @details
+ * Same as MatMul but @p left and @p right may be stored column-major as
+ * given by @p left_layout and @p right_layout, i.e. column-major m_i*m_k
+ * matrix is row-major m_k*m_i matrix. Column-major @p right is transposed
+ * on the fly by blocks of rows that fit into cache, so no separate pass
+ * over the whole matrix is done. Result is always row-major.
+ */
+void MatMul(
+    const element_t *left, Layout left_layout, const element_t *right,
+    Layout right_layout, size_t m_i, size_t m_k, size_t m_j,
+    std::function<void(element_t *, const element_t *, element_t, size_t)> fma,
+    element_t *result);
+
+/**
+ * @brief Matrix transpose
+ * @details
+ * Transposes row-major matrix @p src of size rows*cols into row-major
+ * matrix @p dst of size cols*rows. Matrix is processed by cache blocks
+ * of 8x8 byte tiles, each tile is transposed in registers with a single
+ * byte permute when AVX-512 VBMI is available and with SSE2 unpacks
+ * otherwise.
+ */
+void Transpose(const element_t *src, size_t rows, size_t cols, element_t *dst);
+
+/**
+ * @brief x += y, x, y are vectors with length elements
+ * @details
+ * Row addition, i.e. AddScaledRow with z = 1, reduces to plain XOR
+ */
+void AddRow(element_t *x, const element_t *y, size_t length);
+
+/**
+ * Sparse matrix in compressed sparse row (CSR) format. Nonzero entries of
+ * row i are stored in @p columns and @p values at positions
+ * [row_offsets[i], row_offsets[i + 1]) in increasing column order.
+ */
+struct SparseMatrix {
+  size_t rows = 0;
+  size_t cols = 0;
+  std::vector<size_t> row_offsets;
+  std::vector<size_t> columns;
+  std::vector<element_t> values;
+};
+
+/**
+ * @brief Converts row-major dense matrix into CSR format
+ * @param matrix Row-major matrix of size m_i*m_k
+ * @return Sparse matrix holding only nonzero entries of @p matrix
+ */
+SparseMatrix ToSparse(const element_t *matrix, size_t m_i, size_t m_k);
+
+/**
+ * @brief sparse times dense
+ * @details
+ * Multiplies sparse m_i*m_k matrix @p left by row-major m_k*m_j matrix
+ * @p right visiting only nonzero entries of @p left. Entries equal to one
+ * are handled with AddRow, the rest with @p fma which has the same
+ * semantics as in MatMul. Multiplication result is put into @p result
+ */
+void SparseMatMul(
+    const SparseMatrix &left, const element_t *right, size_t m_j,
+    std::function<void(element_t *, const element_t *, element_t, size_t)> fma,
+    element_t *result);
+
 } // namespace gf_2_8
 
 /**
@@ -229,3 +341,217 @@ element_t InvIT(element_t a);
 element_t Pow(element_t a, size_t n);
 
 } // namespace gf_2_16
+
+/**
+ * GF(2^32) field implementation using polynomial representation with
+ * the irreducible polynomial x^32 + x^22 + x^2 + x + 1 (0x1'0040'0007)
+ */
+namespace gf_2_32 {
+
+typedef uint32_t element_t;
+
+/**
+ * Field zero element, 0 for most implementations
+ */
+element_t Zero();
+
+/**
+ * Field unity element, 1 for most implementations
+ */
+element_t One();
+
+/**
+ * Add two elements in GF(2^32)
+ * In GF(2^32), addition is XOR
+ * @param a First element
+ * @param b Second element
+ * @return The sum a + b in GF(2^32)
+ */
+element_t Add(element_t a, element_t b);
+
+/**
+ * Subtract two elements in GF(2^32)
+ * In GF(2^32), subtraction is the same as addition (XOR)
+ * @param a First element
+ * @param b Second element
+ * @return The difference a - b in GF(2^32)
+ */
+element_t Sub(element_t a, element_t b);
+
+/**
+ * Multiply two elements in GF(2^32) bit by bit, reference implementation
+ * @param a First element
+ * @param b Second element
+ * @return The product a * b in GF(2^32)
+ */
+element_t Multiply(element_t a, element_t b);
+
+/**
+ * Multiply two elements in GF(2^32) using carry-less multiplication
+ * (PCLMULQDQ) followed by Barrett reduction
+ * @param a First element
+ * @param b Second element
+ * @return The product a * b in GF(2^32)
+ */
+element_t MultiplyCLMUL(element_t a, element_t b);
+
+/**
+ * Divide two elements in GF(2^32)
+ * @param a First element
+ * @param b Second element (must be non-zero)
+ * @return The quotient a / b in GF(2^32)
+ */
+element_t Div(element_t a, element_t b);
+
+/**
+ * Calculate the inverse of an element in GF(2^32) as a^(2^32 - 2)
+ * @param a The element to invert (must be non-zero)
+ * @return The inverse of a in GF(2^32)
+ */
+element_t Inv(element_t a);
+
+/**
+ * Exponentiate an element in GF(2^32)
+ * @param a The base element
+ * @param n The exponent
+ * @return a^n in GF(2^32)
+ */
+element_t Pow(element_t a, uint64_t n);
+
+/**
+ * @brief x += y * z, x, y are vectors with length elmenets, z - scalar
+ * @details
+ * Performs x += y * z element by element with MultiplyCLMUL
+ */
+void AddScaledRowBase(element_t *x, const element_t *y, element_t z,
+                      size_t length);
+
+/**
+ * @brief x += y * z, x, y are vectors with length elmenets, z - scalar
+ * @details
+ * Performs x += y * z with VPCLMULQDQ on 8 elements at once, each element
+ * is widened to 64 bits, product is reduced with vectorized Barrett
+ * reduction.
+ */
+void AddScaledRowCLMUL(element_t *x, const element_t *y, element_t z,
+                       size_t length);
+
+/**
+ * @brief baseline
+ * @details
+ * Same as gf_2_8::MatMul for GF(2^32) elements
+ */
+void MatMul(
+    const element_t *left, const element_t *right, size_t m_i, size_t m_k,
+    size_t m_j,
+    std::function<void(element_t *, const element_t *, element_t, size_t)> fma,
+    element_t *result);
+
+} // namespace gf_2_32
+
+/**
+ * GF(2^64) field implementation using polynomial representation with
+ * the irreducible polynomial x^64 + x^4 + x^3 + x + 1
+ */
+namespace gf_2_64 {
+
+typedef uint64_t element_t;
+
+/**
+ * Field zero element, 0 for most implementations
+ */
+element_t Zero();
+
+/**
+ * Field unity element, 1 for most implementations
+ */
+element_t One();
+
+/**
+ * Add two elements in GF(2^64)
+ * In GF(2^64), addition is XOR
+ * @param a First element
+ * @param b Second element
+ * @return The sum a + b in GF(2^64)
+ */
+element_t Add(element_t a, element_t b);
+
+/**
+ * Subtract two elements in GF(2^64)
+ * In GF(2^64), subtraction is the same as addition (XOR)
+ * @param a First element
+ * @param b Second element
+ * @return The difference a - b in GF(2^64)
+ */
+element_t Sub(element_t a, element_t b);
+
+/**
+ * Multiply two elements in GF(2^64) bit by bit, reference implementation
+ * @param a First element
+ * @param b Second element
+ * @return The product a * b in GF(2^64)
+ */
+element_t Multiply(element_t a, element_t b);
+
+/**
+ * Multiply two elements in GF(2^64) using carry-less multiplication
+ * (PCLMULQDQ) followed by Barrett reduction
+ * @param a First element
+ * @param b Second element
+ * @return The product a * b in GF(2^64)
+ */
+element_t MultiplyCLMUL(element_t a, element_t b);
+
+/**
+ * Divide two elements in GF(2^64)
+ * @param a First element
+ * @param b Second element (must be non-zero)
+ * @return The quotient a / b in GF(2^64)
+ */
+element_t Div(element_t a, element_t b);
+
+/**
+ * Calculate the inverse of an element in GF(2^64) as a^(2^64 - 2)
+ * @param a The element to invert (must be non-zero)
+ * @return The inverse of a in GF(2^64)
+ */
+element_t Inv(element_t a);
+
+/**
+ * Exponentiate an element in GF(2^64)
+ * @param a The base element
+ * @param n The exponent
+ * @return a^n in GF(2^64)
+ */
+element_t Pow(element_t a, uint64_t n);
+
+/**
+ * @brief x += y * z, x, y are vectors with length elmenets, z - scalar
+ * @details
+ * Performs x += y * z element by element with MultiplyCLMUL
+ */
+void AddScaledRowBase(element_t *x, const element_t *y, element_t z,
+                      size_t length);
+
+/**
+ * @brief x += y * z, x, y are vectors with length elmenets, z - scalar
+ * @details
+ * Performs x += y * z with VPCLMULQDQ on 8 elements at once, even and
+ * odd elements are multiplied separately, product is reduced with
+ * vectorized Barrett reduction.
+ */
+void AddScaledRowCLMUL(element_t *x, const element_t *y, element_t z,
+                       size_t length);
+
+/**
+ * @brief baseline
+ * @details
+ * Same as gf_2_8::MatMul for GF(2^64) elements
+ */
+void MatMul(
+    const element_t *left, const element_t *right, size_t m_i, size_t m_k,
+    size_t m_j,
+    std::function<void(element_t *, const element_t *, element_t, size_t)> fma,
+    element_t *result);
+
+} // namespace gf_2_64
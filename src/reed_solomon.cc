@@ -0,0 +1,487 @@
+#include "reed_solomon.h"
+
+#include <algorithm>
+#include <cstring>
+#include <tuple>
+#include <immintrin.h>
+
+namespace {
+
+#if defined(__GFNI__) and defined(__AVX512BW__)
+/**
+ * Scalar prepared for multiplication of vectors by it
+ */
+struct VectorScalar {
+  __m512i lo;
+  __m512i hi;
+};
+
+/**
+ * Term of error locator evaluated by Chien search at a block of
+ * exponents and multiplier moving it to the next block
+ */
+struct ChienTerm {
+  __m512i value;
+  VectorScalar step;
+};
+#endif
+
+/**
+ * GF(2^8) operations used by generic Reed–Solomon routines
+ */
+struct Field8 {
+  typedef gf_2_8::element_t element_t;
+
+  static constexpr size_t lanes = 64;
+
+  static element_t Alpha() { return 3; }
+
+  static element_t Multiply(element_t a, element_t b) {
+    return gf_2_8::MultiplyLUT(a, b);
+  }
+
+  static element_t Inv(element_t a) { return gf_2_8::Inv(a); }
+
+  static element_t Pow(element_t a, size_t n) {
+    return gf_2_8::Pow(a, static_cast<int>(n % 255));
+  }
+
+#if defined(__GFNI__) and defined(__AVX512BW__)
+  static __m512i Set1(element_t a) { return _mm512_set1_epi8(a); }
+
+  static VectorScalar Broadcast(element_t a) {
+    return {_mm512_set1_epi8(a), _mm512_setzero_si512()};
+  }
+
+  static __m512i Multiply(__m512i v, const VectorScalar &a) {
+    return _mm512_gf2p8mul_epi8(v, a.lo);
+  }
+
+  static uint64_t ZeroMask(__m512i v) {
+    return _mm512_cmpeq_epi8_mask(v, _mm512_setzero_si512());
+  }
+#endif
+};
+
+/**
+ * GF(2^16) operations used by generic Reed–Solomon routines
+ */
+struct Field16 {
+  typedef gf_2_16::element_t element_t;
+
+  static constexpr size_t lanes = 32;
+
+  /**
+   * Minimal generator of the multiplicative group, i.e. element whose
+   * order is 65535 = 3 * 5 * 17 * 257
+   */
+  static element_t Alpha() {
+    static const element_t alpha = [] {
+      for (element_t a = 2;; ++a) {
+        bool primitive = true;
+        for (size_t p : {3, 5, 17, 257}) {
+          primitive &= gf_2_16::Pow(a, 65535 / p) != gf_2_16::One();
+        }
+        if (primitive) {
+          return a;
+        }
+      }
+    }();
+    return alpha;
+  }
+
+  static element_t Multiply(element_t a, element_t b) {
+    return gf_2_16::Multiply(a, b);
+  }
+
+  static element_t Inv(element_t a) { return gf_2_16::Inv(a); }
+
+  static element_t Pow(element_t a, size_t n) { return gf_2_16::Pow(a, n); }
+
+#if defined(__GFNI__) and defined(__AVX512BW__)
+  static __m512i Set1(element_t a) { return _mm512_set1_epi16(a); }
+
+  /**
+   * For v = v_0 + v_1x with v_0, v_1 from GF(2^8) product v * a is
+   * v_0 * a + v_1 * (a * x), both terms are GF(2^8) scalars times
+   * GF(2^16) elements, i.e. bytewise GF(2^8) products
+   */
+  static VectorScalar Broadcast(element_t a) {
+    return {_mm512_set1_epi16(a),
+            _mm512_set1_epi16(gf_2_16::Multiply(a, 0x100))};
+  }
+
+  static __m512i Multiply(__m512i v, const VectorScalar &a) {
+    __m512i lo = _mm512_and_si512(v, _mm512_set1_epi16(0xff));
+    __m512i hi = _mm512_srli_epi16(v, 8);
+    lo = _mm512_or_si512(lo, _mm512_slli_epi16(lo, 8));
+    hi = _mm512_or_si512(hi, _mm512_slli_epi16(hi, 8));
+    return _mm512_xor_si512(_mm512_gf2p8mul_epi8(lo, a.lo),
+                            _mm512_gf2p8mul_epi8(hi, a.hi));
+  }
+
+  static uint64_t ZeroMask(__m512i v) {
+    return _mm512_cmpeq_epi16_mask(v, _mm512_setzero_si512());
+  }
+#endif
+};
+
+/**
+ * Generator polynomial (x - α)...(x - α^parity), highest degree first
+ */
+template <typename F>
+std::vector<typename F::element_t> Generator(size_t parity) {
+  std::vector<typename F::element_t> generator(1, 1);
+  typename F::element_t root = 1;
+  for (size_t i = 0; i < parity; ++i) {
+    root = F::Multiply(root, F::Alpha());
+    generator.push_back(0);
+    for (size_t j = generator.size() - 1; j > 0; --j) {
+      generator[j] ^= F::Multiply(generator[j - 1], root);
+    }
+  }
+  return generator;
+}
+
+template <typename F>
+void Encode(const typename F::element_t *message, size_t k, size_t parity,
+            typename F::element_t *codeword) {
+  auto generator = Generator<F>(parity);
+  std::copy(message, message + k, codeword);
+  if (parity == 0) {
+    return;
+  }
+  // Long division by monic generator, remainder is kept in parity part
+  auto remainder = codeword + k;
+  std::fill(remainder, remainder + parity, 0);
+  for (size_t j = 0; j < k; ++j) {
+    auto feedback = message[j] ^ remainder[0];
+    for (size_t i = 0; i + 1 < parity; ++i) {
+      remainder[i] = remainder[i + 1] ^ F::Multiply(feedback, generator[i + 1]);
+    }
+    remainder[parity - 1] = F::Multiply(feedback, generator[parity]);
+  }
+}
+
+#if defined(__GFNI__) and defined(__AVX512BW__)
+/**
+ * Horner evaluation of F::lanes interleaved codewords at @p count roots,
+ * fixed count lets accumulators stay in registers while codeword symbols
+ * are streamed through
+ */
+template <typename F, size_t count>
+void SyndromesGroup(const typename F::element_t *symbols, size_t n,
+                    size_t batch, const VectorScalar *roots,
+                    typename F::element_t *syndromes) {
+  __m512i acc[count];
+  for (size_t r = 0; r < count; ++r) {
+    acc[r] = _mm512_setzero_si512();
+  }
+  for (size_t j = 0; j < n; ++j, symbols += batch) {
+    auto c = _mm512_loadu_si512(symbols);
+    for (size_t r = 0; r < count; ++r) {
+      acc[r] = _mm512_xor_si512(F::Multiply(acc[r], roots[r]), c);
+    }
+  }
+  for (size_t r = 0; r < count; ++r) {
+    _mm512_storeu_si512(syndromes + r * batch, acc[r]);
+  }
+}
+#endif
+
+template <typename F>
+void Syndromes(const typename F::element_t *codewords, size_t n, size_t parity,
+               size_t batch, typename F::element_t *syndromes) {
+  std::vector<typename F::element_t> roots(parity);
+  for (size_t i = 0; i < parity; ++i) {
+    roots[i] = F::Pow(F::Alpha(), i + 1);
+  }
+  size_t b = 0;
+#if defined(__GFNI__) and defined(__AVX512BW__)
+  constexpr size_t group = 8;
+  std::vector<VectorScalar> vector_roots;
+  for (auto root : roots) {
+    vector_roots.push_back(F::Broadcast(root));
+  }
+  for (; b + F::lanes <= batch; b += F::lanes) {
+    size_t g = 0;
+    for (; g + group <= parity; g += group) {
+      SyndromesGroup<F, group>(codewords + b, n, batch, &vector_roots[g],
+                               syndromes + g * batch + b);
+    }
+    auto args = std::make_tuple(codewords + b, n, batch, vector_roots.data() + g,
+                                syndromes + g * batch + b);
+    switch (parity - g) {
+    case 1:
+      std::apply(SyndromesGroup<F, 1>, args);
+      break;
+    case 2:
+      std::apply(SyndromesGroup<F, 2>, args);
+      break;
+    case 3:
+      std::apply(SyndromesGroup<F, 3>, args);
+      break;
+    case 4:
+      std::apply(SyndromesGroup<F, 4>, args);
+      break;
+    case 5:
+      std::apply(SyndromesGroup<F, 5>, args);
+      break;
+    case 6:
+      std::apply(SyndromesGroup<F, 6>, args);
+      break;
+    case 7:
+      std::apply(SyndromesGroup<F, 7>, args);
+      break;
+    }
+  }
+#endif
+  for (; b < batch; ++b) {
+    for (size_t i = 0; i < parity; ++i) {
+      typename F::element_t s = 0;
+      for (size_t j = 0; j < n; ++j) {
+        s = F::Multiply(s, roots[i]) ^ codewords[j * batch + b];
+      }
+      syndromes[i * batch + b] = s;
+    }
+  }
+}
+
+/**
+ * Berlekamp–Massey algorithm, returns error locator polynomial
+ * Λ(x) = (1 - X_1x)...(1 - X_Lx), lowest degree first
+ */
+template <typename F>
+std::vector<typename F::element_t>
+BerlekampMassey(const std::vector<typename F::element_t> &syndromes) {
+  typedef typename F::element_t element_t;
+  std::vector<element_t> locator(1, 1);
+  std::vector<element_t> previous(1, 1);
+  size_t errors = 0;
+  size_t shift = 1;
+  element_t previous_discrepancy = 1;
+  for (size_t n = 0; n < syndromes.size(); ++n) {
+    element_t discrepancy = syndromes[n];
+    for (size_t i = 1; i <= errors && i < locator.size(); ++i) {
+      discrepancy ^= F::Multiply(locator[i], syndromes[n - i]);
+    }
+    if (discrepancy == 0) {
+      ++shift;
+      continue;
+    }
+    auto scale = F::Multiply(discrepancy, F::Inv(previous_discrepancy));
+    auto updated = locator;
+    if (updated.size() < previous.size() + shift) {
+      updated.resize(previous.size() + shift, 0);
+    }
+    for (size_t i = 0; i < previous.size(); ++i) {
+      updated[i + shift] ^= F::Multiply(scale, previous[i]);
+    }
+    if (2 * errors <= n) {
+      previous = std::move(locator);
+      errors = n + 1 - errors;
+      previous_discrepancy = discrepancy;
+      shift = 1;
+    } else {
+      ++shift;
+    }
+    locator = std::move(updated);
+  }
+  locator.resize(errors + 1);
+  return locator;
+}
+
+/**
+ * Chien search, returns exponents e < n such that Λ(α^{-e}) = 0
+ */
+template <typename F>
+std::vector<size_t> ChienSearch(const std::vector<typename F::element_t> &locator,
+                                size_t n) {
+  typedef typename F::element_t element_t;
+  std::vector<size_t> roots;
+  auto alpha_inv = F::Inv(F::Alpha());
+  size_t e = 0;
+#if defined(__GFNI__) and defined(__AVX512BW__)
+  // Lane l of terms[k - 1].value holds Λ_k α^{-k(e + l)}, moving to the
+  // next block of exponents is multiplication by α^{-k * lanes}
+  std::vector<ChienTerm> terms;
+  element_t initial[F::lanes];
+  for (size_t k = 1; k < locator.size(); ++k) {
+    auto power = F::Pow(alpha_inv, k);
+    auto term = locator[k];
+    for (size_t l = 0; l < F::lanes; ++l) {
+      initial[l] = term;
+      term = F::Multiply(term, power);
+    }
+    terms.push_back(
+        {_mm512_loadu_si512(initial), F::Broadcast(F::Pow(power, F::lanes))});
+  }
+  for (; e + F::lanes <= n; e += F::lanes) {
+    __m512i sum = F::Set1(locator[0]);
+    for (auto &term : terms) {
+      sum = _mm512_xor_si512(sum, term.value);
+      term.value = F::Multiply(term.value, term.step);
+    }
+    uint64_t mask = F::ZeroMask(sum);
+    while (mask) {
+      roots.push_back(e + __builtin_ctzll(mask));
+      mask &= mask - 1;
+    }
+  }
+#endif
+  auto x = F::Pow(alpha_inv, e);
+  for (; e < n; ++e, x = F::Multiply(x, alpha_inv)) {
+    element_t value = 0;
+    for (size_t k = locator.size(); k-- > 0;) {
+      value = F::Multiply(value, x) ^ locator[k];
+    }
+    if (value == 0) {
+      roots.push_back(e);
+    }
+  }
+  return roots;
+}
+
+/**
+ * Evaluates polynomial given lowest degree first at @p x
+ */
+template <typename F>
+typename F::element_t Evaluate(const std::vector<typename F::element_t> &poly,
+                               typename F::element_t x) {
+  typename F::element_t value = 0;
+  for (size_t k = poly.size(); k-- > 0;) {
+    value = F::Multiply(value, x) ^ poly[k];
+  }
+  return value;
+}
+
+/**
+ * Corrects single codeword with nonzero syndromes, symbols are accessed
+ * with @p stride. Returns false if errors can not be corrected.
+ */
+template <typename F>
+bool Correct(typename F::element_t *codeword, size_t stride, size_t n,
+             const std::vector<typename F::element_t> &syndromes) {
+  typedef typename F::element_t element_t;
+  auto locator = BerlekampMassey<F>(syndromes);
+  size_t errors = locator.size() - 1;
+  if (2 * errors > syndromes.size()) {
+    return false;
+  }
+  auto positions = ChienSearch<F>(locator, n);
+  if (positions.size() != errors) {
+    return false;
+  }
+
+  // Error evaluator Ω(x) = S(x)Λ(x) mod x^parity
+  std::vector<element_t> evaluator(syndromes.size(), 0);
+  for (size_t i = 0; i < syndromes.size(); ++i) {
+    for (size_t k = 0; k < locator.size() && i + k < syndromes.size(); ++k) {
+      evaluator[i + k] ^= F::Multiply(syndromes[i], locator[k]);
+    }
+  }
+  // Formal derivative, in characteristic 2 only odd terms survive
+  std::vector<element_t> derivative(locator.size() > 1 ? locator.size() - 1
+                                                       : 1,
+                                    0);
+  for (size_t k = 1; k < locator.size(); k += 2) {
+    derivative[k - 1] = locator[k];
+  }
+
+  // Forney algorithm for roots α^1..α^parity: e = Ω(X^{-1}) / Λ'(X^{-1})
+  std::vector<element_t> magnitudes;
+  auto alpha_inv = F::Inv(F::Alpha());
+  for (auto e : positions) {
+    auto x_inv = F::Pow(alpha_inv, e);
+    auto denominator = Evaluate<F>(derivative, x_inv);
+    if (denominator == 0) {
+      return false;
+    }
+    magnitudes.push_back(F::Multiply(Evaluate<F>(evaluator, x_inv),
+                                     F::Inv(denominator)));
+  }
+  for (size_t l = 0; l < positions.size(); ++l) {
+    codeword[(n - 1 - positions[l]) * stride] ^= magnitudes[l];
+  }
+  return true;
+}
+
+template <typename F>
+std::vector<size_t> DecodeBatch(typename F::element_t *codewords, size_t n,
+                                size_t parity, size_t batch) {
+  typedef typename F::element_t element_t;
+  std::vector<element_t> syndromes(parity * batch);
+  Syndromes<F>(codewords, n, parity, batch, syndromes.data());
+
+  // Clean codewords are detected by OR of all syndrome rows
+  std::vector<element_t> dirty(batch, 0);
+  for (size_t i = 0; i < parity; ++i) {
+    auto row = syndromes.data() + i * batch;
+    for (size_t b = 0; b < batch; ++b) {
+      dirty[b] |= row[b];
+    }
+  }
+
+  std::vector<size_t> failed;
+  std::vector<element_t> codeword_syndromes(parity);
+  for (size_t b = 0; b < batch; ++b) {
+    if (dirty[b] == 0) {
+      continue;
+    }
+    for (size_t i = 0; i < parity; ++i) {
+      codeword_syndromes[i] = syndromes[i * batch + b];
+    }
+    if (!Correct<F>(codewords + b, batch, n, codeword_syndromes)) {
+      failed.push_back(b);
+    }
+  }
+  return failed;
+}
+
+} // namespace
+
+namespace gf_2_8 {
+
+void RSEncode(const element_t *message, size_t k, size_t parity,
+              element_t *codeword) {
+  Encode<Field8>(message, k, parity, codeword);
+}
+
+void RSSyndromes(const element_t *codewords, size_t n, size_t parity,
+                 size_t batch, element_t *syndromes) {
+  Syndromes<Field8>(codewords, n, parity, batch, syndromes);
+}
+
+std::vector<size_t> RSDecodeBatch(element_t *codewords, size_t n,
+                                  size_t parity, size_t batch) {
+  return DecodeBatch<Field8>(codewords, n, parity, batch);
+}
+
+bool RSDecode(element_t *codeword, size_t n, size_t parity) {
+  return RSDecodeBatch(codeword, n, parity, 1).empty();
+}
+
+} // namespace gf_2_8
+
+namespace gf_2_16 {
+
+void RSEncode(const element_t *message, size_t k, size_t parity,
+              element_t *codeword) {
+  Encode<Field16>(message, k, parity, codeword);
+}
+
+void RSSyndromes(const element_t *codewords, size_t n, size_t parity,
+                 size_t batch, element_t *syndromes) {
+  Syndromes<Field16>(codewords, n, parity, batch, syndromes);
+}
+
+std::vector<size_t> RSDecodeBatch(element_t *codewords, size_t n,
+                                  size_t parity, size_t batch) {
+  return DecodeBatch<Field16>(codewords, n, parity, batch);
+}
+
+bool RSDecode(element_t *codeword, size_t n, size_t parity) {
+  return RSDecodeBatch(codeword, n, parity, 1).empty();
+}
+
+} // namespace gf_2_16
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "field.h"
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Reed–Solomon codes with error (unknown positions) correction.
+ *
+ * Codeword of length n is a polynomial c(x) = c[0]x^{n-1} + ... + c[n-1]
+ * divisible by generator polynomial g(x) = (x - α)(x - α^2)...(x - α^p)
+ * where p = n - k is the number of parity symbols, so up to p / 2 errors
+ * are corrected. Encoding is systematic: message is followed by parity.
+ *
+ * Batches of codewords are stored interleaved, i.e. symbol j of codeword
+ * b is at position j * batch + b, which lets syndromes be computed for
+ * many codewords at once with vector instructions.
+ */
+namespace gf_2_8 {
+
+/**
+ * @brief Systematic encoding
+ * @details
+ * gf_2_8::Init() must be called before using Reed–Solomon functions.
+ * @param message k message symbols
+ * @param k Message length, k + parity must not exceed 255
+ * @param parity Number of parity symbols
+ * @param codeword Output of k + parity symbols, message followed by parity
+ */
+void RSEncode(const element_t *message, size_t k, size_t parity,
+              element_t *codeword);
+
+/**
+ * @brief Syndromes of a batch of codewords
+ * @details
+ * Computes S_i = c(α^{i+1}), i = 0..parity-1, by Horner scheme
+ * vectorized over codewords of the batch with GFNI.
+ * @param codewords Interleaved batch of codewords of length n
+ * @param syndromes Output parity*batch syndromes, S_i of codeword b is at
+ * position i * batch + b
+ */
+void RSSyndromes(const element_t *codewords, size_t n, size_t parity,
+                 size_t batch, element_t *syndromes);
+
+/**
+ * @brief Corrects errors in a batch of codewords in place
+ * @details
+ * Codewords with all syndromes zero are left untouched, the others are
+ * decoded with Berlekamp–Massey, Chien search and Forney algorithm.
+ * @param codewords Interleaved batch of codewords of length n
+ * @return Indices of codewords that have more errors than can be
+ * corrected, such codewords are left unmodified
+ */
+std::vector<size_t> RSDecodeBatch(element_t *codewords, size_t n,
+                                  size_t parity, size_t batch);
+
+/**
+ * @brief Corrects errors in a single codeword in place
+ * @return false if codeword has more errors than can be corrected, such
+ * codeword is left unmodified
+ */
+bool RSDecode(element_t *codeword, size_t n, size_t parity);
+
+} // namespace gf_2_8
+
+namespace gf_2_16 {
+
+/**
+ * @brief Systematic encoding
+ * @details
+ * Same as gf_2_8::RSEncode, k + parity must not exceed 65535.
+ * gf_2_8::Init() must be called before using Reed–Solomon functions.
+ */
+void RSEncode(const element_t *message, size_t k, size_t parity,
+              element_t *codeword);
+
+/**
+ * @brief Syndromes of a batch of codewords
+ * @details
+ * Same as gf_2_8::RSSyndromes, multiplication by root is done with
+ * GF(2^8) GFNI multiplication of low and high halves of elements.
+ */
+void RSSyndromes(const element_t *codewords, size_t n, size_t parity,
+                 size_t batch, element_t *syndromes);
+
+/**
+ * @brief Corrects errors in a batch of codewords in place
+ * @details
+ * Same as gf_2_8::RSDecodeBatch
+ */
+std::vector<size_t> RSDecodeBatch(element_t *codewords, size_t n,
+                                  size_t parity, size_t batch);
+
+/**
+ * @brief Corrects errors in a single codeword in place
+ * @return false if codeword has more errors than can be corrected, such
+ * codeword is left unmodified
+ */
+bool RSDecode(element_t *codeword, size_t n, size_t parity);
+
+} // namespace gf_2_16
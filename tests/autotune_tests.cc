@@ -0,0 +1,114 @@
+#include "autotune.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+std::string TuningFilePath() {
+  return (std::filesystem::temp_directory_path() / "galois_tuning_test")
+      .string();
+}
+
+/**
+ * Checks MatMulTuned against MatMul with binary tables
+ */
+void CheckMatMulTuned(size_t n, size_t m, size_t l) {
+  std::mt19937 rng(42);
+  std::vector<gf_2_8::element_t> left(n * m), right(m * l);
+  std::vector<gf_2_8::element_t> result(n * l), ref(n * l);
+  for (auto &x : left) {
+    x = rng();
+  }
+  for (auto &x : right) {
+    x = rng();
+  }
+  gf_2_8::MatMulTuned(left.data(), right.data(), n, m, l, result.data());
+  gf_2_8::MatMul(left.data(), right.data(), n, m, l, gf_2_8::AddScaledRowBase,
+                 ref.data());
+  ASSERT_EQ(result, ref);
+}
+
+TEST(GF_2_8, MatMulTunedDefault) {
+  gf_2_8::ResetTuning();
+  CheckMatMulTuned(10, 20, 300);
+}
+
+TEST(GF_2_8, Autotune) {
+  gf_2_8::ResetTuning();
+  auto path = TuningFilePath();
+  std::filesystem::remove(path);
+  ASSERT_TRUE(gf_2_8::SetTuningFile(path));
+
+  // Cache miss with tuning file set runs autotuning and persists result
+  auto config = gf_2_8::TunedConfig(30, 30, 2000);
+  ASSERT_TRUE(std::filesystem::exists(path));
+  CheckMatMulTuned(30, 30, 2000);
+
+  // Same shape class is served from the file after restart
+  gf_2_8::ResetTuning();
+  ASSERT_TRUE(gf_2_8::SetTuningFile(path));
+  auto loaded = gf_2_8::TunedConfig(32, 17, 1025);
+  ASSERT_EQ(loaded.kernel, config.kernel);
+  ASSERT_EQ(loaded.tile_columns, config.tile_columns);
+
+  gf_2_8::ResetTuning();
+  std::filesystem::remove(path);
+}
+
+TEST(GF_2_8, TuningFile) {
+  gf_2_8::ResetTuning();
+  auto path = TuningFilePath();
+  {
+    std::ofstream out(path);
+    out << "# log2(m_i) log2(m_k) log2(m_j) kernel tile_columns\n";
+    out << "3 4 8 base 64\n";
+    out << "3 4 9 gfni_general 0\n";
+  }
+  ASSERT_TRUE(gf_2_8::SetTuningFile(path));
+  auto config = gf_2_8::TunedConfig(8, 16, 256);
+  ASSERT_EQ(config.kernel, gf_2_8::RowKernel::kBase);
+  ASSERT_EQ(config.tile_columns, 64);
+  config = gf_2_8::TunedConfig(5, 9, 300);
+  ASSERT_EQ(config.kernel, gf_2_8::RowKernel::kGFNIGeneral);
+  ASSERT_EQ(config.tile_columns, 0);
+  CheckMatMulTuned(8, 16, 256);
+  CheckMatMulTuned(5, 9, 300);
+
+  gf_2_8::ResetTuning();
+  std::filesystem::remove(path);
+}
+
+TEST(GF_2_8, TuningFileRejected) {
+  gf_2_8::ResetTuning();
+  auto path = TuningFilePath();
+  const std::string contents = "3 4 8 base 64\n"
+                               "3 4 9 unknown 0\n";
+  {
+    std::ofstream out(path);
+    out << contents;
+  }
+  ASSERT_FALSE(gf_2_8::SetTuningFile(path));
+
+  // Valid lines before the broken one are not loaded
+  auto config = gf_2_8::TunedConfig(8, 16, 256);
+  ASSERT_EQ(config.tile_columns, 0);
+
+  // File is not set, so cache misses are not tuned and written into it
+  gf_2_8::TunedConfig(30, 30, 2000);
+  CheckMatMulTuned(30, 30, 2000);
+  std::ifstream in(path);
+  std::string read((std::istreambuf_iterator<char>(in)),
+                   std::istreambuf_iterator<char>());
+  ASSERT_EQ(read, contents);
+
+  gf_2_8::ResetTuning();
+  std::filesystem::remove(path);
+}
+
+} // namespace
@@ -49,7 +49,7 @@ TEST(GF_2_8, RowMulAdd) {
       data[j] = rng();
       y[j] = rng();
     }
-    gf_2_8::element_t z = 1;
+    gf_2_8::element_t z = rng();
 
     std::copy(data.begin(), data.end(), x.begin());
     gf_2_8::AddScaledRowBase(x.data(), y.data(), z, length);
@@ -117,6 +117,154 @@ TEST(GF_2_8, MatMul) {
   }
 }
 
+TEST(GF_2_8, SparseMatMul) {
+  gf_2_8::Init();
+  gf_2_8::InitGFNI();
+  std::mt19937 rng(42);
+
+  std::vector<gf_2_8::element_t> left;
+  std::vector<gf_2_8::element_t> right;
+  std::vector<gf_2_8::element_t> result;
+  std::vector<gf_2_8::element_t> ref;
+
+  for (size_t density = 0; density <= 100; density += 10) {
+    for (size_t n = 5; n < 10; ++n) {
+      for (size_t l = 60; l < 70; ++l) {
+        size_t m = 2 * n;
+        left.resize(n * m);
+        right.resize(m * l);
+        result.resize(n * l);
+        ref.resize(n * l);
+        for (auto &x : left) {
+          // Half of nonzero entries are ones to cover the XOR path
+          x = (rng() % 100 < density) ? ((rng() & 1) ? 1 : rng() | 1) : 0;
+        }
+        for (auto &x : right) {
+          x = rng();
+        }
+
+        auto sparse = gf_2_8::ToSparse(left.data(), n, m);
+        ASSERT_EQ(sparse.row_offsets.size(), n + 1);
+        ASSERT_EQ(sparse.columns.size(),
+                  n * m - std::count(left.begin(), left.end(), 0));
+
+        gf_2_8::MatMul(left.data(), right.data(), n, m, l,
+                       gf_2_8::AddScaledRowBase, ref.data());
+        gf_2_8::SparseMatMul(sparse, right.data(), l,
+                             gf_2_8::AddScaledRowGFNIDedicated, result.data());
+        ASSERT_EQ(std::equal(ref.begin(), ref.end(), result.begin()), true);
+      }
+    }
+  }
+}
+
+TEST(GF_2_8, MatMulStreaming) {
+  gf_2_8::Init();
+  gf_2_8::InitGFNI();
+  std::mt19937 rng(42);
+
+  for (size_t n : {1, 4, 9}) {
+    for (size_t m : {1, 3, 10}) {
+      for (size_t l : {50, 1000, 4100}) {
+        std::vector<gf_2_8::element_t> left(n * m);
+        std::vector<gf_2_8::element_t> right(m * l);
+        std::vector<gf_2_8::element_t> result(n * l), ref(n * l);
+        for (auto &x : left) {
+          x = rng();
+        }
+        for (auto &x : right) {
+          x = rng();
+        }
+        gf_2_8::MatMul(left.data(), right.data(), n, m, l,
+                       gf_2_8::AddScaledRowBase, ref.data());
+
+        for (size_t tile : {64, 100, 4096}) {
+          for (size_t prefetch : {0, 2, 12}) {
+            for (bool non_temporal : {false, true}) {
+              gf_2_8::StreamingParams params;
+              params.tile_columns = tile;
+              params.prefetch_rows = prefetch;
+              params.non_temporal = non_temporal;
+              gf_2_8::MatMulStreaming(left.data(), right.data(), n, m, l,
+                                      gf_2_8::AddScaledRowGFNIDedicated,
+                                      params, result.data());
+              ASSERT_EQ(std::equal(ref.begin(), ref.end(), result.begin()),
+                        true);
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(GF_2_8, Transpose) {
+  std::mt19937 rng(42);
+  for (size_t rows : {1, 7, 8, 63, 64, 65, 130}) {
+    for (size_t cols : {1, 9, 16, 64, 100}) {
+      std::vector<gf_2_8::element_t> src(rows * cols);
+      std::vector<gf_2_8::element_t> dst(rows * cols);
+      for (auto &x : src) {
+        x = rng();
+      }
+      gf_2_8::Transpose(src.data(), rows, cols, dst.data());
+      for (size_t r = 0; r < rows; ++r) {
+        for (size_t c = 0; c < cols; ++c) {
+          ASSERT_EQ(dst[c * rows + r], src[r * cols + c]);
+        }
+      }
+    }
+  }
+}
+
+TEST(GF_2_8, MatMulLayout) {
+  gf_2_8::Init();
+  gf_2_8::InitGFNI();
+  std::mt19937 rng(42);
+  using gf_2_8::Layout;
+
+  std::vector<std::array<size_t, 3>> shapes;
+  for (size_t n : {5, 17}) {
+    for (size_t m : {7, 64, 70}) {
+      for (size_t l : {11, 64, 90}) {
+        shapes.push_back({n, m, l});
+      }
+    }
+  }
+  // Long rows make column-major right operand transposed by several
+  // blocks of rows, the last one being partial
+  shapes.push_back({3, 100, 5000});
+  shapes.push_back({2, 37, 20000});
+
+  for (auto [n, m, l] : shapes) {
+    std::vector<gf_2_8::element_t> left(n * m), left_t(n * m);
+    std::vector<gf_2_8::element_t> right(m * l), right_t(m * l);
+    std::vector<gf_2_8::element_t> result(n * l), ref(n * l);
+    for (auto &x : left) {
+      x = rng();
+    }
+    for (auto &x : right) {
+      x = rng();
+    }
+    gf_2_8::Transpose(left.data(), n, m, left_t.data());
+    gf_2_8::Transpose(right.data(), m, l, right_t.data());
+    gf_2_8::MatMul(left.data(), right.data(), n, m, l,
+                   gf_2_8::AddScaledRowBase, ref.data());
+
+    for (auto left_layout : {Layout::kRowMajor, Layout::kColMajor}) {
+      for (auto right_layout : {Layout::kRowMajor, Layout::kColMajor}) {
+        gf_2_8::MatMul(
+            left_layout == Layout::kRowMajor ? left.data() : left_t.data(),
+            left_layout,
+            right_layout == Layout::kRowMajor ? right.data() : right_t.data(),
+            right_layout, n, m, l, gf_2_8::AddScaledRowGFNIDedicated,
+            result.data());
+        ASSERT_EQ(std::equal(ref.begin(), ref.end(), result.begin()), true);
+      }
+    }
+  }
+}
+
 TEST(GF_2_8, Irreducibly) {
   for (uint16_t x = 0; x < 256; ++x) {
     ASSERT_NE(gf_2_8::Add(gf_2_8::Add(gf_2_8::Multiply(x, x), x), 0x20),
@@ -156,4 +304,152 @@ TEST(GF_2_16, InverseIT) {
   }
 }
 
+TEST(GF_2_32, MultiplyCLMUL) {
+  std::mt19937_64 rng(42);
+  for (size_t i = 0; i < 100000; ++i) {
+    gf_2_32::element_t x = rng();
+    gf_2_32::element_t y = rng();
+    ASSERT_EQ(gf_2_32::Multiply(x, y), gf_2_32::MultiplyCLMUL(x, y));
+  }
+}
+
+TEST(GF_2_32, Inverse) {
+  std::mt19937_64 rng(42);
+  for (size_t i = 0; i < 1000; ++i) {
+    gf_2_32::element_t x = rng() | 1;
+    ASSERT_EQ(gf_2_32::MultiplyCLMUL(x, gf_2_32::Inv(x)), gf_2_32::One());
+    // Holds for every nonzero element iff polynomial is irreducible
+    ASSERT_EQ(gf_2_32::Pow(x, 0xffffffff), gf_2_32::One());
+  }
+}
+
+TEST(GF_2_32, RowMulAdd) {
+  std::mt19937_64 rng(42);
+  constexpr size_t length = 1001;
+  std::vector<gf_2_32::element_t> data(length), y(length), x(length),
+      ref(length);
+  for (size_t i = 0; i < 100; ++i) {
+    for (size_t j = 0; j < length; ++j) {
+      data[j] = rng();
+      y[j] = rng();
+    }
+    gf_2_32::element_t z = rng();
+
+    for (size_t j = 0; j < length; ++j) {
+      ref[j] = data[j] ^ gf_2_32::Multiply(y[j], z);
+    }
+
+    x = data;
+    gf_2_32::AddScaledRowBase(x.data(), y.data(), z, length);
+    ASSERT_EQ(x, ref);
+
+    x = data;
+    gf_2_32::AddScaledRowCLMUL(x.data(), y.data(), z, length);
+    ASSERT_EQ(x, ref);
+  }
+}
+
+TEST(GF_2_32, MatMul) {
+  std::mt19937_64 rng(42);
+  for (size_t n : {3, 8}) {
+    for (size_t m : {5, 9}) {
+      for (size_t l : {7, 16, 21}) {
+        std::vector<gf_2_32::element_t> left(n * m), right(m * l);
+        std::vector<gf_2_32::element_t> result(n * l), ref(n * l, 0);
+        for (auto &x : left) {
+          x = rng();
+        }
+        for (auto &x : right) {
+          x = rng();
+        }
+        gf_2_32::MatMul(left.data(), right.data(), n, m, l,
+                         gf_2_32::AddScaledRowCLMUL, result.data());
+        for (size_t i = 0; i < n; ++i) {
+          for (size_t j = 0; j < l; ++j) {
+            for (size_t k = 0; k < m; ++k) {
+              ref[i * l + j] ^=
+                  gf_2_32::Multiply(left[i * m + k], right[k * l + j]);
+            }
+          }
+        }
+        ASSERT_EQ(result, ref);
+      }
+    }
+  }
+}
+
+TEST(GF_2_64, MultiplyCLMUL) {
+  std::mt19937_64 rng(42);
+  for (size_t i = 0; i < 100000; ++i) {
+    gf_2_64::element_t x = rng();
+    gf_2_64::element_t y = rng();
+    ASSERT_EQ(gf_2_64::Multiply(x, y), gf_2_64::MultiplyCLMUL(x, y));
+  }
+}
+
+TEST(GF_2_64, Inverse) {
+  std::mt19937_64 rng(42);
+  for (size_t i = 0; i < 1000; ++i) {
+    gf_2_64::element_t x = rng() | 1;
+    ASSERT_EQ(gf_2_64::MultiplyCLMUL(x, gf_2_64::Inv(x)), gf_2_64::One());
+    // Holds for every nonzero element iff polynomial is irreducible
+    ASSERT_EQ(gf_2_64::Pow(x, 0xffffffffffffffff), gf_2_64::One());
+  }
+}
+
+TEST(GF_2_64, RowMulAdd) {
+  std::mt19937_64 rng(42);
+  constexpr size_t length = 1001;
+  std::vector<gf_2_64::element_t> data(length), y(length), x(length),
+      ref(length);
+  for (size_t i = 0; i < 100; ++i) {
+    for (size_t j = 0; j < length; ++j) {
+      data[j] = rng();
+      y[j] = rng();
+    }
+    gf_2_64::element_t z = rng();
+
+    for (size_t j = 0; j < length; ++j) {
+      ref[j] = data[j] ^ gf_2_64::Multiply(y[j], z);
+    }
+
+    x = data;
+    gf_2_64::AddScaledRowBase(x.data(), y.data(), z, length);
+    ASSERT_EQ(x, ref);
+
+    x = data;
+    gf_2_64::AddScaledRowCLMUL(x.data(), y.data(), z, length);
+    ASSERT_EQ(x, ref);
+  }
+}
+
+TEST(GF_2_64, MatMul) {
+  std::mt19937_64 rng(42);
+  for (size_t n : {3, 8}) {
+    for (size_t m : {5, 9}) {
+      for (size_t l : {7, 16, 21}) {
+        std::vector<gf_2_64::element_t> left(n * m), right(m * l);
+        std::vector<gf_2_64::element_t> result(n * l), ref(n * l, 0);
+        for (auto &x : left) {
+          x = rng();
+        }
+        for (auto &x : right) {
+          x = rng();
+        }
+        gf_2_64::MatMul(left.data(), right.data(), n, m, l,
+                         gf_2_64::AddScaledRowCLMUL, result.data());
+        for (size_t i = 0; i < n; ++i) {
+          for (size_t j = 0; j < l; ++j) {
+            for (size_t k = 0; k < m; ++k) {
+              ref[i * l + j] ^=
+                  gf_2_64::Multiply(left[i * m + k], right[k * l + j]);
+            }
+          }
+        }
+        ASSERT_EQ(result, ref);
+      }
+    }
+  }
+}
+
 } // namespace
\ No newline at end of file
@@ -0,0 +1,161 @@
+#include "reed_solomon.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+/**
+ * Encodes batch of random messages into interleaved codewords
+ */
+template <typename T, typename Encoder>
+std::vector<T> RandomCodewords(size_t n, size_t parity, size_t batch,
+                               std::mt19937 &rng, Encoder encode) {
+  std::vector<T> codewords(n * batch);
+  std::vector<T> message(n - parity);
+  std::vector<T> codeword(n);
+  for (size_t b = 0; b < batch; ++b) {
+    for (auto &x : message) {
+      x = rng();
+    }
+    encode(message.data(), n - parity, parity, codeword.data());
+    for (size_t j = 0; j < n; ++j) {
+      codewords[j * batch + b] = codeword[j];
+    }
+  }
+  return codewords;
+}
+
+/**
+ * Adds @p errors nonzero errors at distinct positions of codeword @p b
+ */
+template <typename T>
+void AddErrors(std::vector<T> &codewords, size_t n, size_t batch, size_t b,
+               size_t errors, std::mt19937 &rng) {
+  std::vector<size_t> positions(n);
+  for (size_t j = 0; j < n; ++j) {
+    positions[j] = j;
+  }
+  std::shuffle(positions.begin(), positions.end(), rng);
+  for (size_t e = 0; e < errors; ++e) {
+    T error = 0;
+    while (error == 0) {
+      error = rng();
+    }
+    codewords[positions[e] * batch + b] ^= error;
+  }
+}
+
+TEST(GF_2_8, RSSyndromesOfCodewords) {
+  gf_2_8::Init();
+  std::mt19937 rng(42);
+  for (size_t batch : {1, 63, 64, 130}) {
+    for (size_t parity : {2, 16, 32}) {
+      size_t n = 255;
+      auto codewords = RandomCodewords<gf_2_8::element_t>(
+          n, parity, batch, rng, gf_2_8::RSEncode);
+      std::vector<gf_2_8::element_t> syndromes(parity * batch, 1);
+      gf_2_8::RSSyndromes(codewords.data(), n, parity, batch,
+                          syndromes.data());
+      ASSERT_EQ(std::count(syndromes.begin(), syndromes.end(), 0),
+                parity * batch);
+    }
+  }
+}
+
+TEST(GF_2_8, RSDecodeBatch) {
+  gf_2_8::Init();
+  std::mt19937 rng(42);
+  for (size_t n : {40, 255}) {
+    for (size_t parity : {2, 10, 32}) {
+      size_t batch = 100;
+      auto ref = RandomCodewords<gf_2_8::element_t>(n, parity, batch, rng,
+                                                    gf_2_8::RSEncode);
+      auto codewords = ref;
+      for (size_t b = 0; b < batch; ++b) {
+        AddErrors(codewords, n, batch, b, b % (parity / 2 + 1), rng);
+      }
+      auto failed = gf_2_8::RSDecodeBatch(codewords.data(), n, parity, batch);
+      ASSERT_TRUE(failed.empty());
+      ASSERT_EQ(codewords, ref);
+    }
+  }
+}
+
+TEST(GF_2_8, RSDecodeTooManyErrors) {
+  gf_2_8::Init();
+  std::mt19937 rng(42);
+  size_t n = 100;
+  size_t parity = 10;
+  size_t failures = 0;
+  for (size_t i = 0; i < 100; ++i) {
+    auto ref = RandomCodewords<gf_2_8::element_t>(n, parity, 1, rng,
+                                                  gf_2_8::RSEncode);
+    auto codeword = ref;
+    AddErrors(codeword, n, 1, 0, parity / 2 + 1, rng);
+    // Either failure is reported and codeword is left unmodified, or it is
+    // miscorrected into another one, original can not be recovered
+    auto received = codeword;
+    if (!gf_2_8::RSDecode(codeword.data(), n, parity)) {
+      ASSERT_EQ(codeword, received);
+      ++failures;
+    }
+    ASSERT_NE(codeword, ref);
+  }
+  ASSERT_GT(failures, 0);
+}
+
+TEST(GF_2_8, RSEncodeWithoutParity) {
+  gf_2_8::Init();
+  std::vector<gf_2_8::element_t> message = {1, 2, 3, 4};
+  // Spare symbol checks that nothing is written past the codeword
+  std::vector<gf_2_8::element_t> codeword(message.size() + 1, 0xAA);
+  gf_2_8::RSEncode(message.data(), message.size(), 0, codeword.data());
+  ASSERT_TRUE(std::equal(message.begin(), message.end(), codeword.begin()));
+  ASSERT_EQ(codeword.back(), 0xAA);
+}
+
+TEST(GF_2_16, RSDecodeBatch) {
+  gf_2_8::Init();
+  std::mt19937 rng(42);
+  for (size_t n : {30, 1000}) {
+    for (size_t parity : {2, 8, 20}) {
+      size_t batch = 40;
+      auto ref = RandomCodewords<gf_2_16::element_t>(n, parity, batch, rng,
+                                                     gf_2_16::RSEncode);
+      std::vector<gf_2_16::element_t> syndromes(parity * batch, 1);
+      gf_2_16::RSSyndromes(ref.data(), n, parity, batch, syndromes.data());
+      ASSERT_EQ(std::count(syndromes.begin(), syndromes.end(), 0),
+                parity * batch);
+
+      auto codewords = ref;
+      for (size_t b = 0; b < batch; ++b) {
+        AddErrors(codewords, n, batch, b, b % (parity / 2 + 1), rng);
+      }
+      auto failed =
+          gf_2_16::RSDecodeBatch(codewords.data(), n, parity, batch);
+      ASSERT_TRUE(failed.empty());
+      ASSERT_EQ(codewords, ref);
+    }
+  }
+}
+
+TEST(GF_2_16, RSDecode) {
+  gf_2_8::Init();
+  std::mt19937 rng(42);
+  size_t n = 300;
+  size_t parity = 6;
+  for (size_t i = 0; i < 20; ++i) {
+    auto ref = RandomCodewords<gf_2_16::element_t>(n, parity, 1, rng,
+                                                   gf_2_16::RSEncode);
+    auto codeword = ref;
+    AddErrors(codeword, n, 1, 0, parity / 2, rng);
+    ASSERT_TRUE(gf_2_16::RSDecode(codeword.data(), n, parity));
+    ASSERT_EQ(codeword, ref);
+  }
+}
+
+} // namespace